@@ -70,7 +70,7 @@ class Barcode
 	Barcode& setReaderOptions(const ReaderOptions& opts);
 
 	friend Barcode MergeStructuredAppendSequence(const Barcodes&);
-	friend Barcodes ReadBarcodes(const ImageView&, const ReaderOptions&);
+	friend class ReaderContext;
 	friend Barcode CreateBarcode(const void*, int, int, const CreatorOptions&);
 	friend Image WriteBarcodeToImage(const Barcode&, const WriterOptions&);
 	friend std::string WriteBarcodeToSVG(const Barcode&, const WriterOptions&);
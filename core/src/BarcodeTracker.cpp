@@ -0,0 +1,81 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BarcodeTracker.h"
+
+#include "Quadrilateral.h"
+#include "ZXAlgorithms.h"
+
+#include <algorithm>
+
+namespace ZXing {
+
+// The area around a symbol that is searched in the next frame: its bounding box extended by half its size in all
+// directions, which includes the quiet zone and allows for quite some movement. The position of linear symbols is
+// usually just a line, hence the same margin is used horizontally and vertically.
+static Position SearchWindow(const Position& pos)
+{
+	auto bb = BoundingBox(pos);
+	int margin = std::max(bb.bottomRight().x - bb.topLeft().x, bb.bottomRight().y - bb.topLeft().y) / 2 + 8;
+	PointI tl = bb.topLeft() - PointI(margin, margin), br = bb.bottomRight() + PointI(margin, margin);
+	return {tl, {br.x, tl.y}, br, {tl.x, br.y}};
+}
+
+BarcodeTracker::BarcodeTracker(const ReaderOptions& options, int fullScanInterval)
+	: _context(options), _fullScanInterval(std::max(1, fullScanInterval))
+{}
+
+void BarcodeTracker::reset()
+{
+	_positions.clear();
+	_framesSinceFullScan = 0;
+	_tracking = false;
+}
+
+Barcodes BarcodeTracker::read(const ImageView& frame)
+{
+	if (frame.width() != _width || frame.height() != _height) {
+		reset();
+		_width = frame.width();
+		_height = frame.height();
+	}
+
+	Barcodes res;
+
+	_tracking = !_positions.empty() && ++_framesSinceFullScan < _fullScanInterval;
+	const bool readWindows = _tracking;
+	if (_tracking) {
+		std::vector<Position> windows;
+		windows.reserve(_positions.size());
+		for (const auto& pos : _positions)
+			windows.push_back(SearchWindow(pos));
+
+		res = _context.read(frame, windows);
+		// a symbol that was not found again in its window may have left it (e.g. moved too fast) or the frame. Each
+		// window needs a symbol of its own, so a new one showing up in another window does not hide the lost one.
+		std::vector<bool> matched(res.size(), false);
+		_tracking = std::ranges::all_of(windows, [&](const Position& window) -> bool {
+			for (int i = 0; i < Size(res); ++i)
+				if (!matched[i] && res[i].isValid() && IsInside(Center(res[i].position()), window))
+					return matched[i] = true;
+			return false;
+		});
+	}
+
+	if (!_tracking) {
+		// a full scan after the windows is part of the same frame
+		res = readWindows ? _context.readAgain(frame) : _context.read(frame);
+		_framesSinceFullScan = 0;
+	}
+
+	_positions.clear();
+	for (const auto& r : res)
+		if (r.isValid())
+			_positions.push_back(r.position());
+
+	return res;
+}
+
+} // ZXing
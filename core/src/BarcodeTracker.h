@@ -0,0 +1,56 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "Barcode.h"
+#include "ImageView.h"
+#include "ReaderContext.h"
+#include "ReaderOptions.h"
+
+#include <vector>
+
+namespace ZXing {
+
+/**
+ * @brief Reads barcodes from the frames of a video stream, following the symbols from one frame to the next.
+ *
+ * Symbols in a video usually move only a few pixels from one frame to the next. Instead of scanning the full frame,
+ * read() first looks only at small windows around the positions of the symbols found in the previous frame. The full
+ * frame is scanned if not all of those symbols were found again (tracking lost), if there is nothing to track and
+ * periodically every fullScanInterval frames, to pick up new symbols entering the field of view.
+ *
+ * A BarcodeTracker must not be used from multiple threads at the same time.
+ */
+class BarcodeTracker
+{
+	ReaderContext _context;
+	std::vector<Position> _positions; // of the symbols found in the last frame
+	int _fullScanInterval;
+	int _framesSinceFullScan = 0;
+	int _width = 0, _height = 0;
+	bool _tracking = false;
+
+public:
+	explicit BarcodeTracker(const ReaderOptions& options = {}, int fullScanInterval = 10);
+
+	const ReaderOptions& options() const { return _context.options(); }
+
+	/**
+	 * Read barcodes from the next frame of the stream
+	 *
+	 * @param frame  view of the image data including layout and format
+	 * @return List of Barcode found, may be empty
+	 */
+	Barcodes read(const ImageView& frame);
+
+	/// Forget the tracked symbols, the next frame is scanned completely (e.g. after a scene change).
+	void reset();
+
+	/// Returns true if the last frame was read by only looking at the windows around the tracked symbols.
+	bool tracking() const { return _tracking; }
+};
+
+} // ZXing
@@ -6,6 +6,10 @@
 #include "BinaryBitmap.h"
 
 #include "BitMatrix.h"
+#include "PackedBitMatrix.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
 
 namespace ZXing {
 
@@ -14,34 +18,76 @@ struct BinaryBitmap::Cache
 	std::shared_ptr<const BitMatrix> matrix, transposed;
 };
 
-BitMatrix BinaryBitmap::binarize(const uint8_t threshold) const
+std::shared_ptr<BitMatrix> BitMatrixPool::acquire(int width, int height)
 {
-	BitMatrix res(width(), height());
-
-	if (_buffer.pixStride() == 1 && _buffer.rowStride() == _buffer.width()) {
-		// Specialize for a packed buffer with pixStride 1 to support auto vectorization (16x speedup on AVX2)
-		auto dst = res.row(0).begin();
-		for (auto src = _buffer.data(0, 0), end = _buffer.data(0, height()); src != end; ++src, ++dst)
-			*dst = (*src <= threshold) * BitMatrix::SET_V;
-	} else {
-		auto processLine = [&res, threshold](int y, const auto* src, const int stride) {
-			for (auto& dst : res.row(y)) {
-				dst = (*src <= threshold) * BitMatrix::SET_V;
-				src += stride;
-			}
-		};
-		for (int y = 0; y < res.height(); ++y) {
-			auto src = _buffer.data(0, y) + GreenIndex(_buffer.format());
-			// Specialize the inner loop for strides 1 and 4 to support auto vectorization
-			switch (_buffer.pixStride()) {
-			case 1: processLine(y, src, 1); break;
-			case 4: processLine(y, src, 4); break;
-			default: processLine(y, src, _buffer.pixStride()); break;
+	std::scoped_lock lock(_mutex);
+	// a matrix is unused if the pool holds the only reference, nobody else can create a new one concurrently
+	auto i = std::ranges::find_if(_matrices, [](auto& m) { return m.use_count() == 1; });
+	if (i == _matrices.end())
+		i = _matrices.insert(_matrices.end(), std::make_shared<BitMatrix>());
+	(*i)->reset(width, height);
+	return *i;
+}
+
+std::shared_ptr<BitMatrix> BinaryBitmap::newBitMatrix(int width, int height) const
+{
+	return _pool ? _pool->acquire(width, height) : std::make_shared<BitMatrix>(width, height);
+}
+
+std::shared_ptr<BitMatrix> BinaryBitmap::binarize(const uint8_t threshold) const
+{
+	auto matrix = newBitMatrix(width(), height());
+	auto& res = *matrix;
+
+	forEachBand(1, [&](int y0, int y1) {
+		if (_buffer.pixStride() == 1 && _buffer.rowStride() == _buffer.width()) {
+			// Specialize for a packed buffer with pixStride 1 to support auto vectorization (16x speedup on AVX2)
+			auto dst = res.row(y0).begin();
+			for (auto src = _buffer.data(0, y0), end = _buffer.data(0, y1); src != end; ++src, ++dst)
+				*dst = (*src <= threshold) * BitMatrix::SET_V;
+		} else {
+			auto processLine = [&res, threshold](int y, const auto* src, const int stride) {
+				for (auto& dst : res.row(y)) {
+					dst = (*src <= threshold) * BitMatrix::SET_V;
+					src += stride;
+				}
+			};
+			for (int y = y0; y < y1; ++y) {
+				auto src = _buffer.data(0, y) + GreenIndex(_buffer.format());
+				// Specialize the inner loop for strides 1 and 4 to support auto vectorization
+				switch (_buffer.pixStride()) {
+				case 1: processLine(y, src, 1); break;
+				case 4: processLine(y, src, 4); break;
+				default: processLine(y, src, _buffer.pixStride()); break;
+				}
 			}
 		}
+	});
+
+	return matrix;
+}
+
+void BinaryBitmap::forEachBand(int alignment, const std::function<void(int, int)>& func) const
+{
+	// bands smaller than this are not worth the synchronization overhead
+	constexpr int MIN_BAND_PIXELS = 256 * 1024;
+
+	const int height = this->height();
+	int numBands = 1;
+	int bandHeight = height;
+	if (_maxThreads != 1) {
+		// create more bands than threads for a better load balance
+		bandHeight = std::max(height / (2 * ResolveMaxThreads(_maxThreads)), MIN_BAND_PIXELS / std::max(1, width()));
+		bandHeight = std::max(alignment, (bandHeight + alignment - 1) / alignment * alignment);
+		// the last band includes the remaining rows, so it is at least bandHeight rows high
+		numBands = std::max(1, height / bandHeight);
 	}
 
-	return res;
+	if (numBands == 1)
+		return func(0, height);
+
+	ParallelFor(_executor, _maxThreads, numBands,
+				[&](int i) { func(i * bandHeight, i == numBands - 1 ? height : (i + 1) * bandHeight); });
 }
 
 BinaryBitmap::BinaryBitmap(const ImageView& buffer) : _cache(new Cache), _buffer(buffer) {}
@@ -55,9 +101,10 @@ const BitMatrix* BinaryBitmap::getBitMatrix(bool transposed) const
 	}
 	if (transposed) {
 		if (!_cache->transposed) {
-			auto copy = std::make_shared<BitMatrix>(_cache->matrix->copy());
-			copy->rotate90();
-			_cache->transposed = std::move(copy);
+			// same as copy() + rotate90() but without the intermediate copy
+			auto res = newBitMatrix(height(), width());
+			PackedBitMatrix(*_cache->matrix).transposed().toBitMatrix(*res, true);
+			_cache->transposed = std::move(res);
 		}
 		return _cache->transposed.get();
 	}
@@ -75,34 +122,11 @@ void BinaryBitmap::invert()
 	_inverted = !_inverted;
 }
 
-template <typename F>
-void SumFilter(const BitMatrix& in, BitMatrix& out, F func)
-{
-	assert(in.height() >= 3);
-
-	const auto* in0 = in.row(0).begin();
-	const auto* in1 = in.row(1).begin();
-	const auto* in2 = in.row(2).begin();
-
-	for (auto *out1 = out.row(1).begin() + 1, *end = out.row(out.height() - 1).begin() - 1; out1 != end; ++in0, ++in1, ++in2, ++out1) {
-		int sum = 0;
-		for (int j = 0; j < 3; ++j)
-			sum += in0[j] + in1[j] + in2[j];
-
-		*out1 = func(sum);
-	}
-}
-
 void BinaryBitmap::close()
 {
 	if (_cache->matrix) {
 		auto& matrix = *const_cast<BitMatrix*>(_cache->matrix.get());
-		BitMatrix tmp(matrix.width(), matrix.height());
-
-		// dilate
-		SumFilter(matrix, tmp, [](int sum) { return (sum > 0 * BitMatrix::SET_V) * BitMatrix::SET_V; });
-		// erode
-		SumFilter(tmp, matrix, [](int sum) { return (sum == 9 * BitMatrix::SET_V) * BitMatrix::SET_V; });
+		PackedBitMatrix(matrix).dilated().eroded().toBitMatrix(matrix);
 	}
 	_cache->transposed.reset();
 	_closed = true;
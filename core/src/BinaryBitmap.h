@@ -10,15 +10,32 @@
 #include "ImageView.h"
 
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace ZXing {
 
 class BitMatrix;
+class Executor;
 
 using PatternRow = std::vector<uint16_t>;
 
+/**
+* Keeps the BitMatrix objects of destroyed BinaryBitmaps for reuse by later ones, so that binarizing a series of
+* images does not allocate new buffers each time (see ReaderContext). Can be used concurrently.
+*/
+class BitMatrixPool
+{
+	std::mutex _mutex;
+	std::vector<std::shared_ptr<BitMatrix>> _matrices;
+
+public:
+	/// Returns an unused matrix of the given size with all bits unset.
+	std::shared_ptr<BitMatrix> acquire(int width, int height);
+};
+
 /**
 * This class is the core bitmap class used by ZXing to represent 1 bit data. Reader objects
 * accept a BinaryBitmap and attempt to decode it.
@@ -29,10 +46,19 @@ class BinaryBitmap
 	std::unique_ptr<Cache> _cache;
 	bool _inverted = false;
 	bool _closed = false;
+	Executor* _executor = nullptr;
+	int _maxThreads = 1;
+	BitMatrixPool* _pool = nullptr;
 
 protected:
 	const ImageView _buffer;
 
+	/**
+	* Calls func(y0, y1) for horizontal bands [y0, y1) covering all rows, concurrently if enabled via setConcurrency().
+	* Band boundaries are multiples of alignment and every band is at least alignment rows high (if the image is).
+	*/
+	void forEachBand(int alignment, const std::function<void(int, int)>& func) const;
+
 	/**
 	* Converts a 2D array of luminance data to 1 bit (true means black).
 	*
@@ -40,7 +66,10 @@ protected:
 	*/
 	virtual std::shared_ptr<const BitMatrix> getBlackMatrix() const = 0;
 
-	BitMatrix binarize(uint8_t threshold) const;
+	/// Returns a new matrix with all bits unset, taken from the pool if one was set.
+	std::shared_ptr<BitMatrix> newBitMatrix(int width, int height) const;
+
+	std::shared_ptr<BitMatrix> binarize(uint8_t threshold) const;
 
 public:
 	BinaryBitmap(const ImageView& buffer);
@@ -61,6 +90,16 @@ public:
 
 	void close();
 	bool closed() const { return _closed; }
+
+	/// Allow getBlackMatrix() to binarize horizontal bands of large images concurrently on the given executor.
+	void setConcurrency(Executor* executor, int maxThreads)
+	{
+		_executor = executor;
+		_maxThreads = maxThreads;
+	}
+
+	/// Allocate the bit matrices from the given pool, which has to outlive this object.
+	void setMatrixPool(BitMatrixPool* pool) { _pool = pool; }
 };
 
 } // ZXing
@@ -6,6 +6,7 @@
 
 #include "BitMatrix.h"
 
+#include "PackedBitMatrix.h"
 #include "Pattern.h"
 
 #include <algorithm>
@@ -39,15 +40,8 @@ BitMatrix::setRegion(int left, int top, int width, int height)
 void
 BitMatrix::rotate90()
 {
-	BitMatrix result(height(), width());
-	for (int x = 0; x < width(); ++x) {
-		for (int y = 0; y < height(); ++y) {
-			if (get(x, y)) {
-				result.set(y, width() - x - 1);
-			}
-		}
-	}
-	*this = std::move(result);
+	// rotating by 90 degree clockwise is a transposition followed by a vertical flip
+	*this = PackedBitMatrix(*this).transposed().toBitMatrix(true);
 }
 
 void
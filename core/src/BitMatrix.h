@@ -9,11 +9,13 @@
 
 #include "Matrix.h"
 #include "Point.h"
+#include "Version.h" // ZXING_BOUNDS_CHECKS
 
 #ifdef ZXING_INTERNAL
 #include "Range.h"
 #endif
 
+#include <cassert>
 #include <cstdint>
 #include <stdexcept>
 #include <vector>
@@ -38,7 +40,7 @@ class BitMatrix
 
 	const data_t& get(int i) const
 	{
-#if 1
+#ifdef ZXING_BOUNDS_CHECKS
 		return _bits.at(i);
 #else
 		return _bits[i];
@@ -82,6 +84,16 @@ public:
 	{
 		return {{_bits.data() + x + (_height - 1) * _width, -_width}, {_bits.data() + x - _width, -_width}};
 	}
+
+	/// Change the size and unset all bits, the memory is only reallocated if it grows.
+	void reset(int width, int height)
+	{
+		if (width != 0 && (width * static_cast<int64_t>(height)) > INT32_MAX)
+			throw std::invalid_argument("Invalid size: width * height is too big");
+		_width = width;
+		_height = height;
+		_bits.assign(width * height, UNSET_V);
+	}
 #endif
 
 	bool get(int x, int y) const { return get(y * _width + x); }
@@ -147,6 +159,17 @@ public:
 
 	bool get(PointI p) const { return get(p.x, p.y); }
 	bool get(PointF p) const { return get(PointI(p)); }
+
+	/**
+	 * Access without bounds checks, even if ZXING_BOUNDS_CHECKS is defined. Only to be used in hot loops where isIn(p)
+	 * has already been established, e.g. by checking the corners of the sampled region.
+	 */
+	template <typename T>
+	bool getUnchecked(PointT<T> p) const
+	{
+		assert(isIn(p));
+		return _bits[PointI(p).y * _width + PointI(p).x];
+	}
 	void set(PointI p, bool v = true) { set(p.x, p.y, v); }
 	void set(PointF p, bool v = true) { set(PointI(p), v); }
 };
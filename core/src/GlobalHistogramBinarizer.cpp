@@ -9,10 +9,14 @@
 #include "BitMatrix.h"
 #include "Pattern.h"
 #include "ZXConfig.h"
+#include "ZXSimd.h"
 
 #include <algorithm>
 #include <array>
+#include <mutex>
+#include <thread>
 #include <utility>
+#include <vector>
 
 namespace ZXing {
 
@@ -22,7 +26,40 @@ static constexpr int LUMINANCE_BUCKETS = 1 << LUMINANCE_BITS;
 
 using Histogram = std::array<uint16_t, LUMINANCE_BUCKETS>;
 
-GlobalHistogramBinarizer::GlobalHistogramBinarizer(const ImageView& buffer) : BinaryBitmap(buffer) {}
+// The rotated 1D scan reads the image column by column, which touches a new cache line for every pixel. Instead of
+// transposing the whole image up front, the columns are copied in tiles of TILE_WIDTH adjacent columns, reading one
+// cache line per image row. The row scan visits the columns above and below the middle alternately, every few
+// columns apart, so a handful of tiles covers many consecutive requests. Every thread scanning the image (e.g. the
+// row bands of a parallel scan) has its own set of tiles, so the threads neither wait for nor evict each other.
+struct GlobalHistogramBinarizer::ColumnTiles
+{
+	static constexpr int TILE_WIDTH = 64;
+	static constexpr int NUM_TILES = 4;
+
+	struct Set
+	{
+		std::array<int, NUM_TILES> x0 = {-1, -1, -1, -1};
+		std::array<std::vector<uint8_t>, NUM_TILES> columns; // column-major, i.e. transposed
+		int next = 0;
+	};
+
+	std::mutex mutex; // only guards the lookup in sets, not the tiles themselves
+	std::vector<std::pair<std::thread::id, std::unique_ptr<Set>>> sets;
+
+	Set& ofThisThread()
+	{
+		const auto id = std::this_thread::get_id();
+		std::scoped_lock lock(mutex);
+		auto i = std::ranges::find(sets, id, &decltype(sets)::value_type::first);
+		if (i == sets.end())
+			return *sets.emplace_back(id, std::make_unique<Set>()).second;
+		return *i->second;
+	}
+};
+
+GlobalHistogramBinarizer::GlobalHistogramBinarizer(const ImageView& buffer)
+	: BinaryBitmap(buffer), _columnTiles(std::make_unique<ColumnTiles>())
+{}
 
 GlobalHistogramBinarizer::~GlobalHistogramBinarizer() = default;
 
@@ -129,6 +166,100 @@ static int EstimateBlackPoint(const Histogram& buckets)
 	return bestValley << LUMINANCE_SHIFT;
 }
 
+using TransposeKernel = void (*)(const uint8_t* src, int srcStride, uint8_t* dst, int dstStride);
+
+// Transpose a block of 16x16 bytes. Interleaving row i with row i + 8 four times in a row results in the transposed
+// block, which needs only unpack (SSE2) or zip (NEON) operations.
+#ifdef ZX_SIMD_X86
+ZX_TARGET("sse2") static void Transpose16x16SSE2(const uint8_t* src, int srcStride, uint8_t* dst, int dstStride)
+{
+	__m128i r[16], t[16];
+	for (int i = 0; i < 16; ++i)
+		r[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * srcStride));
+	for (int s = 0; s < 4; ++s) {
+		for (int i = 0; i < 8; ++i) {
+			t[2 * i] = _mm_unpacklo_epi8(r[i], r[i + 8]);
+			t[2 * i + 1] = _mm_unpackhi_epi8(r[i], r[i + 8]);
+		}
+		std::copy_n(t, 16, r);
+	}
+	for (int i = 0; i < 16; ++i)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * dstStride), r[i]);
+}
+#endif
+
+#ifdef ZX_SIMD_NEON
+static void Transpose16x16NEON(const uint8_t* src, int srcStride, uint8_t* dst, int dstStride)
+{
+	uint8x16_t r[16], t[16];
+	for (int i = 0; i < 16; ++i)
+		r[i] = vld1q_u8(src + i * srcStride);
+	for (int s = 0; s < 4; ++s) {
+		for (int i = 0; i < 8; ++i) {
+			uint8x16x2_t z = vzipq_u8(r[i], r[i + 8]);
+			t[2 * i] = z.val[0];
+			t[2 * i + 1] = z.val[1];
+		}
+		std::copy_n(t, 16, r);
+	}
+	for (int i = 0; i < 16; ++i)
+		vst1q_u8(dst + i * dstStride, r[i]);
+}
+#endif
+
+static void Transpose16x16Scalar(const uint8_t* src, int srcStride, uint8_t* dst, int dstStride)
+{
+	for (int y = 0; y < 16; ++y)
+		for (int x = 0; x < 16; ++x)
+			dst[x * dstStride + y] = src[y * srcStride + x];
+}
+
+static TransposeKernel SelectTransposeKernel()
+{
+#if defined(ZX_SIMD_X86)
+	if (ZX_CPU_SUPPORTS("sse2"))
+		return Transpose16x16SSE2;
+#elif defined(ZX_SIMD_NEON)
+	return Transpose16x16NEON;
+#endif
+	return Transpose16x16Scalar;
+}
+
+void GlobalHistogramBinarizer::copyColumn(int x, bool bottomUp, std::vector<uint8_t>& res) const
+{
+	using Tiles = ColumnTiles;
+	static const TransposeKernel transpose16x16 = SelectTransposeKernel();
+	const int h = height();
+
+	auto& t = _columnTiles->ofThisThread();
+	const int x0 = x / Tiles::TILE_WIDTH * Tiles::TILE_WIDTH;
+	int i = narrow_cast<int>(std::ranges::find(t.x0, x0) - t.x0.begin());
+	if (i == Tiles::NUM_TILES) {
+		i = std::exchange(t.next, (t.next + 1) % Tiles::NUM_TILES);
+		const int n = std::min(Tiles::TILE_WIDTH, width() - x0);
+		auto& columns = t.columns[i];
+		columns.resize(Tiles::TILE_WIDTH * h);
+		// the bulk is transposed in blocks of 16x16 pixels, the remaining rows and columns one pixel at a time
+		const int n16 = _buffer.pixStride() == 1 ? n / 16 * 16 : 0, h16 = h / 16 * 16;
+		for (int y = 0; y < h16; y += 16)
+			for (int c = 0; c < n16; c += 16)
+				transpose16x16(_buffer.data(x0 + c, y), _buffer.rowStride(), &columns[c * h + y], h);
+		for (int y = 0; y < h; ++y) {
+			const uint8_t* src = _buffer.data(x0, y);
+			for (int c = y < h16 ? n16 : 0; c < n; ++c)
+				columns[c * h + y] = src[c * _buffer.pixStride()];
+		}
+		t.x0[i] = x0;
+	}
+
+	auto column = t.columns[i].begin() + (x - x0) * h;
+	res.resize(h);
+	if (bottomUp)
+		std::reverse_copy(column, column + h, res.begin());
+	else
+		std::copy(column, column + h, res.begin());
+}
+
 bool GlobalHistogramBinarizer::getPatternRow(int row, int rotation, PatternRow& res) const
 {
 	auto buffer = _buffer.rotated(rotation);
@@ -137,13 +268,16 @@ bool GlobalHistogramBinarizer::getPatternRow(int row, int rotation, PatternRow&
 	if (buffer.width() < 3)
 		return false; // special casing the code below for a width < 3 makes no sense
 
+	ZX_THREAD_LOCAL std::vector<uint8_t> line;
+	if (const int rot = (rotation + 360) % 360; rot == 90 || rot == 270) {
+		// a row of the rotated view is a column of _buffer, 90 degrees means bottom up, see ColumnTiles
+		copyColumn(rot == 90 ? row : width() - 1 - row, rot == 90, line);
+		lineView = {{line.data(), 1}, {line.data() + line.size(), 1}};
+	}
 #if defined(__AVX__) || defined(__ARM_NEON)
-	// If we are extracting a column (instead of a row), we run into cache misses on every pixel access both
-	// during the histogram calculation and during the sharpen+threshold operation. Additionally, if we
-	// perform the ThresholdSharpened function on pixStride==1 data, the auto-vectorizer makes that part
+	// If we perform the ThresholdSharpened function on pixStride==1 data, the auto-vectorizer makes that part
 	// 8x faster on an AVX2 cpu which easily recovers the extra cost that we pay for the copying.
-	ZX_THREAD_LOCAL std::vector<uint8_t> line;
-	if (std::abs(buffer.pixStride()) > 4) {
+	else if (std::abs(buffer.pixStride()) > 4) {
 		line.resize(lineView.size());
 		std::copy(lineView.begin(), lineView.end(), line.begin());
 		lineView = {{line.data(), 1}, {line.data() + line.size(), 1}};
@@ -181,7 +315,7 @@ GlobalHistogramBinarizer::getBlackMatrix() const
 			const uint8_t* luminances = _buffer.data(0, row);
 			int right = (width() * 4) / 5;
 			for (int x = width() / 5; x < right; x++)
-				localBuckets[luminances[x] >> LUMINANCE_SHIFT]++;
+				localBuckets[luminances[x * _buffer.pixStride()] >> LUMINANCE_SHIFT]++;
 		}
 	}
 
@@ -191,7 +325,7 @@ GlobalHistogramBinarizer::getBlackMatrix() const
 
 
 
-	return std::make_shared<const BitMatrix>(binarize(blackPoint));
+	return binarize(blackPoint);
 }
 
 } // ZXing
@@ -8,6 +8,9 @@
 
 #include "BinaryBitmap.h"
 
+#include <memory>
+#include <vector>
+
 namespace ZXing {
 
 /**
@@ -23,6 +26,11 @@ namespace ZXing {
 */
 class GlobalHistogramBinarizer : public BinaryBitmap
 {
+	struct ColumnTiles;
+	std::unique_ptr<ColumnTiles> _columnTiles;
+
+	void copyColumn(int x, bool bottomUp, std::vector<uint8_t>& res) const;
+
 public:
 	explicit GlobalHistogramBinarizer(const ImageView& buffer);
 	~GlobalHistogramBinarizer() override;
@@ -63,7 +63,7 @@ DetectorResult SampleGrid(const BitMatrix& image, int width, int height, const R
 						sum += image.get(p + PointF(dx, dy));
 				if (sum >= 5)
 #else
-				if (image.get(p))
+				if (image.getUnchecked(p))
 #endif
 					res.set(x, y);
 			}
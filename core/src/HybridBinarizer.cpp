@@ -8,6 +8,8 @@
 
 #include "BitMatrix.h"
 #include "Matrix.h"
+#include "ZXAlgorithms.h"
+#include "ZXSimd.h"
 
 #include <algorithm>
 #include <cstdint>
@@ -26,6 +28,10 @@ static constexpr int MIN_DYNAMIC_RANGE = 24;
 
 HybridBinarizer::HybridBinarizer(const ImageView& iv) : GlobalHistogramBinarizer(iv) {}
 
+HybridBinarizer::HybridBinarizer(const ImageView& iv, Matrix<uint8_t> blockThresholds)
+	: GlobalHistogramBinarizer(iv), _blockThresholds(std::move(blockThresholds))
+{}
+
 HybridBinarizer::~HybridBinarizer() = default;
 
 bool HybridBinarizer::getPatternRow(int row, int rotation, PatternRow& res) const
@@ -47,6 +53,161 @@ bool HybridBinarizer::getPatternRow(int row, int rotation, PatternRow& res) cons
 
 using T_t = uint8_t;
 
+// SIMD kernels for the two operations that touch every pixel. They support a pixel stride of 1 and 2 (e.g. the
+// luminance channel of YUYV data), process a prefix of the n pixels and return its length. The rest is left for
+// the scalar code.
+//   MinMax:    min[x] = min(min[x], src[x * S]), max[x] = max(max[x], src[x * S])
+//   Threshold: dst[x] = src[x * S] <= t[x] ? SET_V : 0
+
+struct Kernels
+{
+	int (*minMax)(const uint8_t* src, int n, uint8_t* min, uint8_t* max) = nullptr;
+	int (*threshold)(const uint8_t* src, int n, const uint8_t* t, uint8_t* dst) = nullptr;
+};
+
+static_assert(BitMatrix::SET_V == 0xff, "the SIMD threshold kernels rely on SET_V having all bits set");
+
+// The loops below stop early enough that the last (strided) load does not read beyond the last pixel.
+
+#ifdef ZX_SIMD_X86
+
+template <int S>
+ZX_TARGET("sse2") static inline __m128i Load16(const uint8_t* p)
+{
+	if constexpr (S == 1) {
+		return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+	} else {
+		const __m128i even = _mm_set1_epi16(0xff);
+		return _mm_packus_epi16(_mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), even),
+								_mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)), even));
+	}
+}
+
+template <int S>
+ZX_TARGET("sse2") static int MinMaxSSE2(const uint8_t* src, int n, uint8_t* min, uint8_t* max)
+{
+	int x = 0;
+	for (; x + 16 <= n - (S - 1); x += 16) {
+		__m128i v = Load16<S>(src + x * S);
+		auto* pMin = reinterpret_cast<__m128i*>(min + x);
+		auto* pMax = reinterpret_cast<__m128i*>(max + x);
+		_mm_storeu_si128(pMin, _mm_min_epu8(_mm_loadu_si128(pMin), v));
+		_mm_storeu_si128(pMax, _mm_max_epu8(_mm_loadu_si128(pMax), v));
+	}
+	return x;
+}
+
+template <int S>
+ZX_TARGET("sse2") static int ThresholdSSE2(const uint8_t* src, int n, const uint8_t* t, uint8_t* dst)
+{
+	int x = 0;
+	for (; x + 16 <= n - (S - 1); x += 16) {
+		__m128i v = Load16<S>(src + x * S);
+		__m128i thr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(t + x));
+		// v <= thr  <=>  min(v, thr) == v
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_cmpeq_epi8(_mm_min_epu8(v, thr), v));
+	}
+	return x;
+}
+
+template <int S>
+ZX_TARGET("avx2") static inline __m256i Load32(const uint8_t* p)
+{
+	if constexpr (S == 1) {
+		return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+	} else {
+		const __m256i even = _mm256_set1_epi16(0xff);
+		__m256i packed = _mm256_packus_epi16(_mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), even),
+											 _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32)), even));
+		// packus works within the 128 bit lanes, restore the order of the 64 bit quarters
+		return _mm256_permute4x64_epi64(packed, 0xD8);
+	}
+}
+
+template <int S>
+ZX_TARGET("avx2") static int MinMaxAVX2(const uint8_t* src, int n, uint8_t* min, uint8_t* max)
+{
+	int x = 0;
+	for (; x + 32 <= n - (S - 1); x += 32) {
+		__m256i v = Load32<S>(src + x * S);
+		auto* pMin = reinterpret_cast<__m256i*>(min + x);
+		auto* pMax = reinterpret_cast<__m256i*>(max + x);
+		_mm256_storeu_si256(pMin, _mm256_min_epu8(_mm256_loadu_si256(pMin), v));
+		_mm256_storeu_si256(pMax, _mm256_max_epu8(_mm256_loadu_si256(pMax), v));
+	}
+	return x + MinMaxSSE2<S>(src + x * S, n - x, min + x, max + x);
+}
+
+template <int S>
+ZX_TARGET("avx2") static int ThresholdAVX2(const uint8_t* src, int n, const uint8_t* t, uint8_t* dst)
+{
+	int x = 0;
+	for (; x + 32 <= n - (S - 1); x += 32) {
+		__m256i v = Load32<S>(src + x * S);
+		__m256i thr = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(t + x));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), _mm256_cmpeq_epi8(_mm256_min_epu8(v, thr), v));
+	}
+	return x + ThresholdSSE2<S>(src + x * S, n - x, t + x, dst + x);
+}
+
+#endif // ZX_SIMD_X86
+
+#ifdef ZX_SIMD_NEON
+
+template <int S>
+static inline uint8x16_t Load16(const uint8_t* p)
+{
+	if constexpr (S == 1)
+		return vld1q_u8(p);
+	else
+		return vld2q_u8(p).val[0];
+}
+
+template <int S>
+static int MinMaxNEON(const uint8_t* src, int n, uint8_t* min, uint8_t* max)
+{
+	int x = 0;
+	for (; x + 16 <= n - (S - 1); x += 16) {
+		uint8x16_t v = Load16<S>(src + x * S);
+		vst1q_u8(min + x, vminq_u8(vld1q_u8(min + x), v));
+		vst1q_u8(max + x, vmaxq_u8(vld1q_u8(max + x), v));
+	}
+	return x;
+}
+
+template <int S>
+static int ThresholdNEON(const uint8_t* src, int n, const uint8_t* t, uint8_t* dst)
+{
+	int x = 0;
+	for (; x + 16 <= n - (S - 1); x += 16)
+		vst1q_u8(dst + x, vcleq_u8(Load16<S>(src + x * S), vld1q_u8(t + x)));
+	return x;
+}
+
+#endif // ZX_SIMD_NEON
+
+template <int S>
+static Kernels SelectKernels()
+{
+#if defined(ZX_SIMD_X86)
+	if (ZX_CPU_SUPPORTS("avx2"))
+		return {MinMaxAVX2<S>, ThresholdAVX2<S>};
+	if (ZX_CPU_SUPPORTS("sse2"))
+		return {MinMaxSSE2<S>, ThresholdSSE2<S>};
+#elif defined(ZX_SIMD_NEON)
+	return {MinMaxNEON<S>, ThresholdNEON<S>};
+#endif
+	return {};
+}
+
+static const Kernels& SelectKernels(int pixStride)
+{
+	static const Kernels stride1 = SelectKernels<1>(), stride2 = SelectKernels<2>(), none = {};
+	return pixStride == 1 ? stride1 : pixStride == 2 ? stride2 : none;
+}
+
+#ifndef USE_NEW_ALGORITHM
+
 /**
 * Applies a single threshold to a block of pixels.
 */
@@ -62,8 +223,6 @@ static void ThresholdBlock(const uint8_t* __restrict luminances, int xoffset, in
 	}
 }
 
-#ifndef USE_NEW_ALGORITHM
-
 /**
 * Calculates a single black point for each block of pixels and saves it away.
 * See the following thread for a discussion of this algorithm:
@@ -191,52 +350,42 @@ static std::shared_ptr<BitMatrix> CalculateMatrix(const uint8_t* __restrict lumi
 // (max - min > MIN_DYNAMIC_RANGE) ? (max + min) / 2 : 0
 static Matrix<T_t> BlockThresholds(const ImageView iv)
 {
-	int subWidth = (iv.width() + BLOCK_SIZE - 1) / BLOCK_SIZE; // ceil(width/BS)
-	int subHeight = (iv.height() + BLOCK_SIZE - 1) / BLOCK_SIZE; // ceil(height/BS)
-
-	Matrix<T_t> thresholds(subWidth, subHeight);
-
-	for (int y = 0; y < subHeight; y++) {
-		int y0 = std::min(y * BLOCK_SIZE, iv.height() - BLOCK_SIZE);
-		for (int x = 0; x < subWidth; x++) {
-			int x0 = std::min(x * BLOCK_SIZE, iv.width() - BLOCK_SIZE);
-			uint8_t min = 255;
-			uint8_t max = 0;
-			for (int yy = 0; yy < BLOCK_SIZE; yy++) {
-				auto line = iv.data(x0, y0 + yy);
-				for (int xx = 0; xx < BLOCK_SIZE; xx++)
-					UpdateMinMax(min, max, line[xx]);
-			}
-
-			thresholds(x, y) = (max - min > MIN_DYNAMIC_RANGE) ? (int(max) + min) / 2 : 0;
-		}
-	}
-
-	return thresholds;
+	BlockThresholdsBuilder builder(iv.width(), iv.height());
+	for (int y = 0; y < iv.height(); y++)
+		builder.addRow(y, iv.data(0, y), iv.pixStride());
+	return builder.thresholds();
 }
 
 // Apply gaussian-like smoothing filter over all non-zero thresholds and fill any remaining gaps with nearest neighbor
 static Matrix<T_t> SmoothThresholds(Matrix<T_t>&& in)
 {
-	Matrix<T_t> out(in.width(), in.height());
+	const int width = in.width(), height = in.height();
+	Matrix<T_t> out(width, height);
 
+	// The sum and the number of non-zero values in the window around each (clamped) center are computed with a
+	// separable box filter: first sum up each column of the window, then add up the column sums of each row.
 	constexpr int R = WINDOW_SIZE / BLOCK_SIZE / 2;
-	for (int y = 0; y < in.height(); y++) {
-		for (int x = 0; x < in.width(); x++) {
-			int left = std::clamp(x, R, in.width() - R - 1);
-			int top = std::clamp(y, R, in.height() - R - 1);
+	Matrix<uint16_t> colSum(width, height), colCount(width, height);
+	for (int y = 0; y < height; y++) {
+		int top = std::clamp(y, R, height - R - 1);
+		for (int dy = -R; dy <= R; ++dy)
+			for (int x = 0; x < width; x++) {
+				int t = in(x, top + dy);
+				colSum(x, y) += t;
+				colCount(x, y) += t > 0;
+			}
+	}
+
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			int left = std::clamp(x, R, width - R - 1);
 
 			int sum = in(x, y) * 2;
 			int n = (sum > 0) * 2;
-			auto add = [&](int x, int y) {
-				int t = in(x, y);
-				sum += t;
-				n += t > 0;
-			};
-
-			for (int dy = -R; dy <= R; ++dy)
-				for (int dx = -R; dx <= R; ++dx)
-					add(left + dx, top + dy);
+			for (int dx = -R; dx <= R; ++dx) {
+				sum += colSum(left + dx, y);
+				n += colCount(left + dx, y);
+			}
 
 			out(x, y) = n > 0 ? sum / n : 0;
 		}
@@ -256,47 +405,118 @@ static Matrix<T_t> SmoothThresholds(Matrix<T_t>&& in)
 	return out;
 }
 
-static std::shared_ptr<BitMatrix> ThresholdImage(const ImageView iv, const Matrix<T_t>& thresholds)
+// Binarize the rows [y0, y1) of the image
+static void ThresholdImage(const ImageView iv, const Matrix<T_t>& thresholds, int y0, int y1, BitMatrix& matrix)
 {
-	auto matrix = std::make_shared<BitMatrix>(iv.width(), iv.height());
+	const int width = iv.width(), height = iv.height(), pixStride = iv.pixStride();
+	const auto& kernels = SelectKernels(pixStride);
+
+	// The threshold of each pixel is the one of its block. The last block in each row/column is aligned with the
+	// right/bottom border and takes precedence where it overlaps with the one before.
+	auto blockIndex = [](int i, int size, int subSize) { return i >= size - BLOCK_SIZE ? subSize - 1 : i / BLOCK_SIZE; };
+
+	std::vector<T_t> rowThresholds(width);
+	for (int y = y0, by = -1; y < y1; y++) {
+		if (by != blockIndex(y, height, thresholds.height())) {
+			by = blockIndex(y, height, thresholds.height());
+			for (int x = 0; x < width; x++)
+				rowThresholds[x] = thresholds(blockIndex(x, width, thresholds.width()), by);
+		}
+
+		auto* src = iv.data(0, y);
+		auto* dst = matrix.row(y).begin();
+		int x = kernels.threshold ? kernels.threshold(src, width, rowThresholds.data(), dst) : 0;
+		for (; x < width; x++)
+			dst[x] = (src[x * pixStride] <= rowThresholds[x]) * BitMatrix::SET_V;
+	}
+}
 
-#ifdef PRINT_DEBUG
-	Matrix<uint8_t> out(iv.width(), iv.height());
 #endif
 
-	for (int y = 0; y < thresholds.height(); y++) {
-		int yoffset = std::min(y * BLOCK_SIZE, iv.height() - BLOCK_SIZE);
-		for (int x = 0; x < thresholds.width(); x++) {
-			int xoffset = std::min(x * BLOCK_SIZE, iv.width() - BLOCK_SIZE);
-			ThresholdBlock(iv.data(), xoffset, yoffset, thresholds(x, y), iv.rowStride(), *matrix);
+BlockThresholdsBuilder::BlockThresholdsBuilder(int width, int height) : _width(width), _height(height)
+{
+	if (width < BLOCK_SIZE || height < BLOCK_SIZE)
+		return;
+
+	int subWidth = (width + BLOCK_SIZE - 1) / BLOCK_SIZE; // ceil(width/BS)
+	int subHeight = (height + BLOCK_SIZE - 1) / BLOCK_SIZE; // ceil(height/BS)
+	_thresholds = Matrix<uint8_t>(subWidth, subHeight);
+	_min.resize(width);
+	_max.resize(width);
+	if (height % BLOCK_SIZE) {
+		_lastMin.resize(width);
+		_lastMax.resize(width);
+	}
+}
 
-#ifdef PRINT_DEBUG
-			for (int yy = 0; yy < 8; ++yy)
-				for (int xx = 0; xx < 8; ++xx)
-					out.set(xoffset + xx, yoffset + yy, thresholds(x, y));
-#endif
+void BlockThresholdsBuilder::addRow(int y, const uint8_t* row, int pixStride)
+{
+	if (_thresholds.size() == 0)
+		return;
+
+	const auto& kernels = SelectKernels(pixStride);
+
+	// collect the min/max of each column of the current block row, reduce them to one value per block after the
+	// last row of the block row
+	auto add = [&](std::vector<uint8_t>& min, std::vector<uint8_t>& max, bool first, bool last, int by) {
+		if (first) {
+			std::fill(min.begin(), min.end(), 255);
+			std::fill(max.begin(), max.end(), 0);
 		}
-	}
 
-#ifdef PRINT_DEBUG
-	std::ofstream file("thresholds_new.pnm");
-	file << "P5\n" << out.width() << ' ' << out.height() << "\n255\n";
-	file.write(reinterpret_cast<const char*>(out.data()), out.size());
-#endif
+		int x = kernels.minMax ? kernels.minMax(row, _width, min.data(), max.data()) : 0;
+		for (; x < _width; x++)
+			UpdateMinMax(min[x], max[x], row[x * pixStride]);
 
-	return matrix;
+		if (!last)
+			return;
+
+		// the last block in each row is aligned with the right border, so it may overlap with the one before
+		for (int bx = 0; bx < _thresholds.width(); bx++) {
+			int x0 = std::min(bx * BLOCK_SIZE, _width - BLOCK_SIZE);
+			int bMin = *std::min_element(&min[x0], &min[x0] + BLOCK_SIZE);
+			int bMax = *std::max_element(&max[x0], &max[x0] + BLOCK_SIZE);
+			_thresholds(bx, by) = (bMax - bMin > MIN_DYNAMIC_RANGE) ? (bMax + bMin) / 2 : 0;
+		}
+	};
+
+	// the same holds for the last block row, which is collected separately, since it may overlap with the one before
+	const int subHeight = _thresholds.height();
+	if (y / BLOCK_SIZE < subHeight - 1 || _height % BLOCK_SIZE == 0)
+		add(_min, _max, y % BLOCK_SIZE == 0, y % BLOCK_SIZE == BLOCK_SIZE - 1, y / BLOCK_SIZE);
+	if (_height % BLOCK_SIZE && y >= _height - BLOCK_SIZE)
+		add(_lastMin, _lastMax, y == _height - BLOCK_SIZE, y == _height - 1, subHeight - 1);
 }
 
-#endif
+Matrix<uint8_t> BlockThresholdsBuilder::thresholds() const
+{
+	return _thresholds.copy();
+}
 
 std::shared_ptr<const BitMatrix> HybridBinarizer::getBlackMatrix() const
 {
 	if (width() >= WINDOW_SIZE && height() >= WINDOW_SIZE) {
 #ifdef USE_NEW_ALGORITHM
-		auto thrs = SmoothThresholds(BlockThresholds(_buffer));
+		// The image is processed in horizontal bands that can be binarized concurrently (see forEachBand). The
+		// result does not depend on the band layout: Bands start at block boundaries and the last one ends with the
+		// (bottom aligned) last block row, so the block thresholds of each band can be computed like those of a
+		// separate image. The smoothing looks at neighboring blocks and is done for the whole (small) matrix at once.
+		Matrix<T_t> blockThresholds = _blockThresholds.copy();
+		if (blockThresholds.size() == 0) {
+			blockThresholds = Matrix<T_t>((width() + BLOCK_SIZE - 1) / BLOCK_SIZE, (height() + BLOCK_SIZE - 1) / BLOCK_SIZE);
+			forEachBand(BLOCK_SIZE, [&](int y0, int y1) {
+				auto band = BlockThresholds(_buffer.cropped(0, y0, 0, y1 - y0));
+				std::copy(band.begin(), band.end(), &blockThresholds(0, y0 / BLOCK_SIZE));
+			});
+		}
+
+		auto thrs = SmoothThresholds(std::move(blockThresholds));
 		if (std::ranges::max(thrs) == 0)
 			return GlobalHistogramBinarizer::getBlackMatrix();
-		return ThresholdImage(_buffer, thrs);
+
+		auto matrix = newBitMatrix(width(), height());
+		forEachBand(1, [&](int y0, int y1) { ThresholdImage(_buffer, thrs, y0, y1, *matrix); });
+		return matrix;
 #else
 		const uint8_t* luminances = _buffer.data();
 		int subWidth = (width() + BLOCK_SIZE - 1) / BLOCK_SIZE; // ceil(width/BS)
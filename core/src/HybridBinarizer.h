@@ -7,6 +7,10 @@
 #pragma once
 
 #include "GlobalHistogramBinarizer.h"
+#include "Matrix.h"
+
+#include <cstdint>
+#include <vector>
 
 namespace ZXing {
 
@@ -29,12 +33,37 @@ namespace ZXing {
 */
 class HybridBinarizer : public GlobalHistogramBinarizer
 {
+	Matrix<uint8_t> _blockThresholds;
+
 public:
 	explicit HybridBinarizer(const ImageView& iv);
+	/// Use precomputed (see BlockThresholdsBuilder) instead of computing the per block thresholds from iv.
+	HybridBinarizer(const ImageView& iv, Matrix<uint8_t> blockThresholds);
 	~HybridBinarizer() override;
 
 	bool getPatternRow(int row, int rotation, PatternRow &res) const override;
 	std::shared_ptr<const BitMatrix> getBlackMatrix() const override;
 };
 
+/**
+ * Computes the per block thresholds of the HybridBinarizer from image rows that are fed to it in top to bottom
+ * order. This way they can be collected in the same pass that produces the rows (e.g. while downscaling an image),
+ * while the pixels are still in the cache.
+ */
+class BlockThresholdsBuilder
+{
+	int _width, _height;
+	Matrix<uint8_t> _thresholds;
+	// per column min/max of the rows of the current and the last block row (which may overlap with the one before)
+	std::vector<uint8_t> _min, _max, _lastMin, _lastMax;
+
+public:
+	BlockThresholdsBuilder(int width, int height);
+
+	void addRow(int y, const uint8_t* row, int pixStride = 1);
+
+	/// Returns the thresholds after all rows have been added or an empty matrix if the image is too small.
+	Matrix<uint8_t> thresholds() const;
+};
+
 } // ZXing
@@ -25,6 +25,14 @@ enum class ImageFormat : uint32_t
 	ARGB = 0x04010203,
 	BGRA = 0x04020100,
 	ABGR = 0x04030201,
+	// Camera frames in YUV formats are read from their luminance (Y) channel only, no color conversion is needed.
+	// The planar 4:2:0 formats store the full resolution Y plane first, so the frame buffer can be passed as is.
+	NV12 = Lum, ///< semi-planar YUV 4:2:0, Y plane followed by interleaved UV
+	NV21 = Lum, ///< semi-planar YUV 4:2:0, Y plane followed by interleaved VU
+	I420 = Lum, ///< planar YUV 4:2:0, Y plane followed by U and V plane
+	YV12 = Lum, ///< planar YUV 4:2:0, Y plane followed by V and U plane
+	YUYV = 0x02000000, ///< packed YUV 4:2:2 (aka YUY2), Y in the even bytes
+	UYVY = 0x02010101, ///< packed YUV 4:2:2, Y in the odd bytes
 	RGBX [[deprecated("use RGBA")]] = RGBA,
 	XRGB [[deprecated("use ARGB")]] = ARGB,
 	BGRX [[deprecated("use BGRA")]] = BGRA,
@@ -0,0 +1,194 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "LumImage.h"
+
+#include "ZXSimd.h"
+
+#include <cstring>
+
+namespace ZXing {
+
+namespace {
+
+// Byte layout of a 3 or 4 byte pixel
+struct PixelLayout
+{
+	int stride, r, g, b;
+};
+
+// Converts a prefix of the n pixels in src and returns its length, the rest is left for the scalar code.
+using RowKernel = int (*)(const uint8_t* src, uint8_t* dst, int n, const PixelLayout& l);
+
+} // namespace
+
+#ifdef ZX_SIMD_X86
+
+// The pixels are deinterleaved with pshufb into 16 bit (R, G) and (B, 0) pairs so that pmaddwd can compute
+// 306 * R + 601 * G and 117 * B as 32 bit values. Every 16 byte load contributes 4 pixels.
+
+struct ShuffleMasks
+{
+	__m128i rg, b;
+
+	ZX_TARGET("ssse3") explicit ShuffleMasks(const PixelLayout& l)
+	{
+		alignas(16) uint8_t rgIdx[16], bIdx[16];
+		for (int i = 0; i < 4; ++i) {
+			rgIdx[4 * i + 0] = l.stride * i + l.r;
+			rgIdx[4 * i + 1] = 0x80;
+			rgIdx[4 * i + 2] = l.stride * i + l.g;
+			rgIdx[4 * i + 3] = 0x80;
+			bIdx[4 * i + 0] = l.stride * i + l.b;
+			bIdx[4 * i + 1] = bIdx[4 * i + 2] = bIdx[4 * i + 3] = 0x80;
+		}
+		rg = _mm_load_si128(reinterpret_cast<const __m128i*>(rgIdx));
+		b = _mm_load_si128(reinterpret_cast<const __m128i*>(bIdx));
+	}
+};
+
+ZX_TARGET("ssse3") static inline __m128i Lum4(const uint8_t* src, const ShuffleMasks& m)
+{
+	__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+	__m128i rg = _mm_madd_epi16(_mm_shuffle_epi8(v, m.rg), _mm_set1_epi32(306 | (601 << 16)));
+	__m128i b = _mm_madd_epi16(_mm_shuffle_epi8(v, m.b), _mm_set1_epi32(117));
+	return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(rg, b), _mm_set1_epi32(0x200)), 10);
+}
+
+ZX_TARGET("ssse3") static int ExtractLumRowSSSE3(const uint8_t* src, uint8_t* dst, int n, const PixelLayout& l)
+{
+	const ShuffleMasks m(l);
+	const int s = l.stride;
+	int x = 0;
+	// the last 16 byte load of each iteration must not read beyond the n pixels
+	for (; s * (x + 12) + 16 <= s * n; x += 16) {
+		const uint8_t* p = src + s * x;
+		__m128i a = _mm_packs_epi32(Lum4(p, m), Lum4(p + 4 * s, m));
+		__m128i b = _mm_packs_epi32(Lum4(p + 8 * s, m), Lum4(p + 12 * s, m));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(a, b));
+	}
+	return x;
+}
+
+ZX_TARGET("avx2") static inline __m256i Lum8(const uint8_t* lo, const uint8_t* hi, __m256i rgMask, __m256i bMask)
+{
+	__m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lo))),
+										_mm_loadu_si128(reinterpret_cast<const __m128i*>(hi)), 1);
+	__m256i rg = _mm256_madd_epi16(_mm256_shuffle_epi8(v, rgMask), _mm256_set1_epi32(306 | (601 << 16)));
+	__m256i b = _mm256_madd_epi16(_mm256_shuffle_epi8(v, bMask), _mm256_set1_epi32(117));
+	return _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(rg, b), _mm256_set1_epi32(0x200)), 10);
+}
+
+ZX_TARGET("avx2") static int ExtractLumRowAVX2(const uint8_t* src, uint8_t* dst, int n, const PixelLayout& l)
+{
+	const ShuffleMasks m(l);
+	const __m256i rgMask = _mm256_broadcastsi128_si256(m.rg), bMask = _mm256_broadcastsi128_si256(m.b);
+	const int s = l.stride;
+	int x = 0;
+	for (; s * (x + 28) + 16 <= s * n; x += 32) {
+		const uint8_t* p = src + s * x;
+		// the 128 bit lanes are packed independently, so put pixels [0, 16) in the low and [16, 32) in the high lane
+		__m256i a = _mm256_packs_epi32(Lum8(p, p + 16 * s, rgMask, bMask), Lum8(p + 4 * s, p + 20 * s, rgMask, bMask));
+		__m256i b = _mm256_packs_epi32(Lum8(p + 8 * s, p + 24 * s, rgMask, bMask), Lum8(p + 12 * s, p + 28 * s, rgMask, bMask));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), _mm256_packus_epi16(a, b));
+	}
+	return x + ExtractLumRowSSSE3(src + s * x, dst + x, n - x, l);
+}
+
+#endif // ZX_SIMD_X86
+
+#ifdef ZX_SIMD_NEON
+
+static inline uint8x8_t Lum8(uint8x8_t r, uint8x8_t g, uint8x8_t b)
+{
+	uint16x8_t r16 = vmovl_u8(r), g16 = vmovl_u8(g), b16 = vmovl_u8(b);
+	uint32x4_t lo = vmull_n_u16(vget_low_u16(r16), 306);
+	lo = vmlal_n_u16(lo, vget_low_u16(g16), 601);
+	lo = vmlal_n_u16(lo, vget_low_u16(b16), 117);
+	uint32x4_t hi = vmull_n_u16(vget_high_u16(r16), 306);
+	hi = vmlal_n_u16(hi, vget_high_u16(g16), 601);
+	hi = vmlal_n_u16(hi, vget_high_u16(b16), 117);
+	// the rounding shift is equivalent to (x + 0x200) >> 10
+	return vmovn_u16(vcombine_u16(vrshrn_n_u32(lo, 10), vrshrn_n_u32(hi, 10)));
+}
+
+static inline uint8x16_t Lum16(uint8x16_t r, uint8x16_t g, uint8x16_t b)
+{
+	return vcombine_u8(Lum8(vget_low_u8(r), vget_low_u8(g), vget_low_u8(b)),
+					   Lum8(vget_high_u8(r), vget_high_u8(g), vget_high_u8(b)));
+}
+
+static int ExtractLumRowNEON(const uint8_t* src, uint8_t* dst, int n, const PixelLayout& l)
+{
+	int x = 0;
+	if (l.stride == 4) {
+		for (; x + 16 <= n; x += 16) {
+			uint8x16x4_t v = vld4q_u8(src + 4 * x);
+			vst1q_u8(dst + x, Lum16(v.val[l.r], v.val[l.g], v.val[l.b]));
+		}
+	} else {
+		for (; x + 16 <= n; x += 16) {
+			uint8x16x3_t v = vld3q_u8(src + 3 * x);
+			vst1q_u8(dst + x, Lum16(v.val[l.r], v.val[l.g], v.val[l.b]));
+		}
+	}
+	return x;
+}
+
+#endif // ZX_SIMD_NEON
+
+static RowKernel SelectRowKernel()
+{
+#if defined(ZX_SIMD_X86)
+	if (ZX_CPU_SUPPORTS("avx2"))
+		return ExtractLumRowAVX2;
+	if (ZX_CPU_SUPPORTS("ssse3"))
+		return ExtractLumRowSSSE3;
+	return nullptr;
+#elif defined(ZX_SIMD_NEON)
+	return ExtractLumRowNEON;
+#else
+	return nullptr;
+#endif
+}
+
+void ExtractLum(const ImageView& iv, LumImage& res)
+{
+	static const RowKernel rowKernel = SelectRowKernel();
+
+	const int width = iv.width();
+	const int stride = iv.pixStride();
+	const int r = RedIndex(iv.format()), g = GreenIndex(iv.format()), b = BlueIndex(iv.format());
+	const bool isLum = r == g && g == b;
+	const RowKernel kernel = !isLum && (stride == 3 || stride == 4) ? rowKernel : nullptr;
+
+	res.resize(width, iv.height());
+
+	for (int y = 0; y < iv.height(); ++y) {
+		const uint8_t* src = iv.data(0, y);
+		uint8_t* dst = res.data() + y * width;
+		if (isLum) {
+			if (stride == 1)
+				std::memcpy(dst, src, width);
+			else
+				for (int x = 0; x < width; ++x)
+					dst[x] = src[x * stride + r];
+		} else {
+			for (int x = kernel ? kernel(src, dst, width, {stride, r, g, b}) : 0; x < width; ++x) {
+				const uint8_t* p = src + x * stride;
+				dst[x] = RGBToLum(p[r], p[g], p[b]);
+			}
+		}
+	}
+}
+
+LumImage ExtractLum(const ImageView& iv)
+{
+	LumImage res;
+	ExtractLum(iv, res);
+	return res;
+}
+
+} // ZXing
@@ -0,0 +1,50 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "ImageView.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ZXing {
+
+/// An owning, densely packed (pixStride == 1, rowStride == width) ImageFormat::Lum image.
+class LumImage : public ImageView
+{
+	std::vector<uint8_t> _memory;
+
+public:
+	LumImage() = default;
+	LumImage(int width, int height) { resize(width, height); }
+
+	LumImage(LumImage&&) noexcept = default;
+	LumImage& operator=(LumImage&&) noexcept = default;
+
+	using ImageView::data;
+	uint8_t* data() { return _memory.data(); }
+
+	/// Change the size, the memory is only reallocated if it grows. The pixel values are unspecified afterwards.
+	void resize(int width, int height)
+	{
+		_memory.resize(width * height);
+		static_cast<ImageView&>(*this) = ImageView(_memory.data(), width, height, ImageFormat::Lum);
+	}
+};
+
+/**
+ * Convert an arbitrary ImageView to a densely packed luminance image.
+ *
+ * Rows of 3 and 4 byte pixels are converted with SSSE3/AVX2 or NEON code, selected at runtime based on the
+ * CPU features. The result is bit-identical to calling RGBToLum() for every pixel. Luminance-only formats (where
+ * red, green and blue index are the same, e.g. LumA or UYVY) are simply copied.
+ */
+LumImage ExtractLum(const ImageView& iv);
+
+/// Same as above but reuses the memory of res.
+void ExtractLum(const ImageView& iv, LumImage& res);
+
+} // ZXing
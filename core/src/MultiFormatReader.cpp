@@ -104,4 +104,10 @@ Barcodes MultiFormatReader::read(const BinaryBitmap& image, int maxSymbols) cons
 	return res;
 }
 
+void MultiFormatReader::newFrame()
+{
+	for (auto& reader : _readers)
+		reader->newFrame();
+}
+
 } // ZXing
@@ -26,6 +26,9 @@ public:
 
 	Barcodes read(const BinaryBitmap& image, int maxSymbols = 0xFF) const;
 
+	/// See Reader::newFrame()
+	void newFrame();
+
 private:
 	std::vector<std::unique_ptr<Reader>> _readers;
 	const ReaderOptions& _opts;
@@ -0,0 +1,170 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "PackedBitMatrix.h"
+
+#include "BitMatrix.h"
+#include "ZXAlgorithms.h"
+
+#include <algorithm>
+
+namespace ZXing {
+
+using word_t = PackedBitMatrix::word_t;
+static constexpr int WORD_BITS = PackedBitMatrix::WORD_BITS;
+
+PackedBitMatrix::PackedBitMatrix(int width, int height)
+	: _width(width), _height(height), _wordsPerRow((width + WORD_BITS - 1) / WORD_BITS), _words(_wordsPerRow * height, 0)
+{}
+
+// Collect the most significant bit of each of the 8 bytes in 8 consecutive bits (first byte -> lowest bit)
+static inline word_t PackBytes(const uint8_t* src)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	return ((LoadU<uint64_t>(src) & 0x8080808080808080ULL) * 0x0002040810204081ULL) >> 56;
+#else
+	word_t res = 0;
+	for (int i = 0; i < 8; ++i)
+		res |= word_t(src[i] != 0) << i;
+	return res;
+#endif
+}
+
+PackedBitMatrix::PackedBitMatrix(const BitMatrix& bits) : PackedBitMatrix(bits.width(), bits.height())
+{
+	static_assert(BitMatrix::SET_V & 0x80, "PackBytes() relies on the MSB being set for set pixels");
+
+	for (int y = 0; y < _height; ++y) {
+		const uint8_t* src = bits.row(y).begin();
+		word_t* dst = row(y);
+		int x = 0;
+		for (; x + WORD_BITS <= _width; x += WORD_BITS, src += WORD_BITS) {
+			word_t w = 0;
+			for (int i = 0; i < WORD_BITS / 8; ++i)
+				w |= PackBytes(src + 8 * i) << (8 * i);
+			*dst++ = w;
+		}
+		if (x < _width) {
+			word_t w = 0;
+			for (int i = 0; x + i < _width; ++i)
+				w |= word_t(src[i] != 0) << i;
+			*dst = w;
+		}
+	}
+}
+
+BitMatrix PackedBitMatrix::toBitMatrix(bool flipRows) const
+{
+	BitMatrix res(_width, _height);
+	toBitMatrix(res, flipRows);
+	return res;
+}
+
+void PackedBitMatrix::toBitMatrix(BitMatrix& res, bool flipRows) const
+{
+	assert(res.width() == _width && res.height() == _height);
+
+	for (int y = 0; y < _height; ++y) {
+		auto* dst = res.row(flipRows ? _height - 1 - y : y).begin();
+		const word_t* src = row(y);
+		for (int x = 0; x < _width; x += WORD_BITS) {
+			word_t w = *src++;
+			for (int i = 0, n = std::min(WORD_BITS, _width - x); i < n; ++i)
+				*dst++ = ((w >> i) & 1) * BitMatrix::SET_V;
+		}
+	}
+}
+
+void PackedBitMatrix::flipAll()
+{
+	if (_words.empty())
+		return;
+
+	for (auto& w : _words)
+		w = ~w;
+
+	// restore the invariant that all bits beyond width() are 0
+	for (int y = 0; y < _height; ++y)
+		row(y)[_wordsPerRow - 1] &= tailMask();
+}
+
+// In-place transpose of a 64x64 bit block (row i is a[i], column j is bit j) by recursively swapping the
+// off-diagonal sub-blocks of size 32, 16, ..., 1 (see Hacker's Delight, 7-3).
+static void Transpose64(word_t a[WORD_BITS])
+{
+	word_t m = 0x00000000FFFFFFFFULL;
+	for (int j = 32; j != 0; j >>= 1, m ^= m << j) {
+		for (int k = 0; k < WORD_BITS; k = ((k | j) + 1) & ~j) {
+			word_t t = ((a[k] >> j) ^ a[k | j]) & m;
+			a[k] ^= t << j;
+			a[k | j] ^= t;
+		}
+	}
+}
+
+PackedBitMatrix PackedBitMatrix::transposed() const
+{
+	PackedBitMatrix res(_height, _width);
+
+	word_t block[WORD_BITS];
+	for (int by = 0; by < _height; by += WORD_BITS) {
+		int rows = std::min(WORD_BITS, _height - by);
+		for (int bx = 0; bx < _wordsPerRow; ++bx) {
+			for (int i = 0; i < WORD_BITS; ++i)
+				block[i] = i < rows ? row(by + i)[bx] : 0;
+
+			Transpose64(block);
+
+			for (int i = 0, n = std::min(WORD_BITS, _width - bx * WORD_BITS); i < n; ++i)
+				res.row(bx * WORD_BITS + i)[by / WORD_BITS] = block[i];
+		}
+	}
+
+	return res;
+}
+
+PackedBitMatrix PackedBitMatrix::dilated() const
+{
+	PackedBitMatrix res(_width, _height);
+	if (_words.empty())
+		return res;
+
+	// horizontal pass: OR each pixel with its left and right neighbor
+	std::vector<word_t> horizontal(_words.size());
+	for (int y = 0; y < _height; ++y) {
+		const word_t* src = row(y);
+		word_t* dst = horizontal.data() + y * _wordsPerRow;
+		for (int i = 0; i < _wordsPerRow; ++i) {
+			word_t prev = i > 0 ? src[i - 1] : 0;
+			word_t next = i < _wordsPerRow - 1 ? src[i + 1] : 0;
+			dst[i] = src[i] | (src[i] << 1) | (prev >> (WORD_BITS - 1)) | (src[i] >> 1) | (next << (WORD_BITS - 1));
+		}
+		dst[_wordsPerRow - 1] &= tailMask();
+	}
+
+	// vertical pass: OR each row with the one above and below
+	for (int y = 0; y < _height; ++y) {
+		const word_t* c = horizontal.data() + y * _wordsPerRow;
+		const word_t* a = y > 0 ? c - _wordsPerRow : c;
+		const word_t* b = y < _height - 1 ? c + _wordsPerRow : c;
+		word_t* dst = res.row(y);
+		for (int i = 0; i < _wordsPerRow; ++i)
+			dst[i] = a[i] | c[i] | b[i];
+	}
+
+	return res;
+}
+
+PackedBitMatrix PackedBitMatrix::eroded() const
+{
+	// erode(A) == ~dilate(~A)
+	PackedBitMatrix inv = *this;
+	inv.flipAll();
+	auto res = inv.dilated();
+	res.flipAll();
+	return res;
+}
+
+} // ZXing
@@ -0,0 +1,80 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace ZXing {
+
+class BitMatrix;
+
+/**
+ * @brief A 2D array of bits, packed 64 pixels per word.
+ *
+ * The byte-per-pixel BitMatrix is the type all detectors and decoders work with since it allows fast random
+ * access. PackedBitMatrix needs only 1/8 of the memory and is meant for bulk operations that touch every pixel
+ * (invert, transpose, morphological filters), where the word-parallel processing pays off.
+ *
+ * Bit x of a row is stored in bit (x % 64) of word (x / 64). Bits beyond width() are always 0.
+ */
+class PackedBitMatrix
+{
+public:
+	using word_t = uint64_t;
+	static constexpr int WORD_BITS = 64;
+
+private:
+	int _width = 0;
+	int _height = 0;
+	int _wordsPerRow = 0;
+	std::vector<word_t> _words;
+
+	word_t tailMask() const { return _width % WORD_BITS ? (word_t(1) << (_width % WORD_BITS)) - 1 : ~word_t(0); }
+
+public:
+	PackedBitMatrix() = default;
+	PackedBitMatrix(int width, int height);
+	explicit PackedBitMatrix(const BitMatrix& bits);
+
+	int width() const { return _width; }
+	int height() const { return _height; }
+	int wordsPerRow() const { return _wordsPerRow; }
+
+	const word_t* row(int y) const { return _words.data() + y * _wordsPerRow; }
+	word_t* row(int y) { return _words.data() + y * _wordsPerRow; }
+
+	bool get(int x, int y) const { return (row(y)[x / WORD_BITS] >> (x % WORD_BITS)) & 1; }
+	void set(int x, int y, bool val = true)
+	{
+		auto& w = row(y)[x / WORD_BITS];
+		auto m = word_t(1) << (x % WORD_BITS);
+		w = val ? w | m : w & ~m;
+	}
+
+	/// Convert back to the byte-per-pixel representation, optionally with the order of the rows reversed.
+	BitMatrix toBitMatrix(bool flipRows = false) const;
+	/// Same as above but writes to res, which has to be of the same size.
+	void toBitMatrix(BitMatrix& res, bool flipRows = false) const;
+
+	void flipAll();
+
+	/// Returns the transposed matrix (x and y swapped), processed in blocks of 64x64 bits.
+	PackedBitMatrix transposed() const;
+
+	/// Returns the result of a 3x3 dilation. Pixels outside the matrix are considered unset.
+	PackedBitMatrix dilated() const;
+
+	/// Returns the result of a 3x3 erosion. Pixels outside the matrix are considered set.
+	PackedBitMatrix eroded() const;
+
+	friend bool operator==(const PackedBitMatrix& a, const PackedBitMatrix& b)
+	{
+		return a._width == b._width && a._height == b._height && a._words == b._words;
+	}
+};
+
+} // ZXing
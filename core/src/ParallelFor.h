@@ -0,0 +1,30 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <functional>
+
+namespace ZXing {
+
+class Executor;
+
+/// The executor used if none was specified: a lazily created ThreadPool with one thread per hardware thread.
+Executor& DefaultExecutor();
+
+/// Returns maxThreads or the number of hardware threads if maxThreads is 0.
+int ResolveMaxThreads(int maxThreads);
+
+/**
+ * Call func(i) for all i in [0, n) using up to maxThreads threads, the calling one included, and return once all
+ * calls are finished. The remaining threads come from the executor (nullptr means DefaultExecutor()). The first
+ * exception thrown by func is rethrown.
+ *
+ * The calling thread processes indices itself and only waits for calls that are already running on other
+ * threads, never for posted tasks to be started. Nested use on the same executor can therefore not deadlock.
+ */
+void ParallelFor(Executor* executor, int maxThreads, int n, const std::function<void(int)>& func);
+
+} // ZXing
@@ -0,0 +1,99 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Pattern.h"
+
+#include "ZXSimd.h"
+
+namespace ZXing {
+
+// The kernels compare every byte with its successor, N bytes at a time. Each set bit in the resulting mask marks the
+// last pixel of a run, whose length is written to res. start is the position of the first pixel of the current run
+// relative to begin, it is negative if the run started before begin.
+
+#ifdef ZX_SIMD_X86
+
+static inline void AddRuns(uint32_t mask, int x, int& start, PatternType*& res)
+{
+	for (; mask; mask &= mask - 1) {
+		int pos = x + std::countr_zero(mask) + 1;
+		*res++ = narrow_cast<PatternType>(pos - start);
+		start = pos;
+	}
+}
+
+ZX_TARGET("sse2") static const uint8_t* RunLengthsSSE2(const uint8_t* begin, const uint8_t* p, const uint8_t* end,
+													   int& start, PatternType*& res)
+{
+	for (; end - p > 16; p += 16) {
+		__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1));
+		AddRuns(~_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) & 0xffff, narrow_cast<int>(p - begin), start, res);
+	}
+	return p;
+}
+
+ZX_TARGET("avx2,bmi") static const uint8_t* RunLengthsAVX2(const uint8_t* begin, const uint8_t* p, const uint8_t* end,
+														   int& start, PatternType*& res)
+{
+	for (; end - p > 32; p += 32) {
+		__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+		__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 1));
+		AddRuns(~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b))), narrow_cast<int>(p - begin), start, res);
+	}
+	return RunLengthsSSE2(begin, p, end, start, res);
+}
+
+#endif // ZX_SIMD_X86
+
+#ifdef ZX_SIMD_NEON
+
+static const uint8_t* RunLengthsNEON(const uint8_t* begin, const uint8_t* p, const uint8_t* end, int& start,
+									 PatternType*& res)
+{
+	for (; end - p > 16; p += 16) {
+		uint8x16_t ne = vmvnq_u8(vceqq_u8(vld1q_u8(p), vld1q_u8(p + 1)));
+		// there is no movemask on NEON, narrowing every 16 bit lane by 4 bits results in 4 bits per byte
+		uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(ne), 4)), 0);
+		int x = narrow_cast<int>(p - begin);
+		for (mask &= 0x8888888888888888ull; mask; mask &= mask - 1) {
+			int pos = x + std::countr_zero(mask) / 4 + 1;
+			*res++ = narrow_cast<PatternType>(pos - start);
+			start = pos;
+		}
+	}
+	return p;
+}
+
+#endif // ZX_SIMD_NEON
+
+using RunLengthsKernel = const uint8_t* (*)(const uint8_t*, const uint8_t*, const uint8_t*, int&, PatternType*&);
+
+static RunLengthsKernel SelectRunLengthsKernel()
+{
+#if defined(ZX_SIMD_X86)
+	if (ZX_CPU_SUPPORTS("avx2") && ZX_CPU_SUPPORTS("bmi"))
+		return RunLengthsAVX2;
+	if (ZX_CPU_SUPPORTS("sse2"))
+		return RunLengthsSSE2;
+#elif defined(ZX_SIMD_NEON)
+	return RunLengthsNEON;
+#endif
+	return nullptr;
+}
+
+const uint8_t* AddRunLengths(const uint8_t* begin, const uint8_t* end, PatternType*& res)
+{
+	static const RunLengthsKernel kernel = SelectRunLengthsKernel();
+	if (!kernel)
+		return begin;
+
+	int start = -*res;
+	auto p = kernel(begin, begin, end, start, res);
+	*res = narrow_cast<PatternType>((p - begin) - start);
+	return p;
+}
+
+} // ZXing
@@ -27,6 +27,8 @@ using PatternType = uint16_t;
 template<int N> using Pattern = std::array<PatternType, N>;
 using PatternRow = std::vector<PatternType>;
 
+class GuardIndex;
+
 class PatternView
 {
 	using Iterator = PatternRow::const_pointer;
@@ -34,6 +36,7 @@ class PatternView
 	int _size = 0;
 	Iterator _base = nullptr;
 	Iterator _end = nullptr;
+	const GuardIndex* _guards = nullptr;
 
 public:
 	using value_type = PatternRow::value_type;
@@ -42,11 +45,14 @@ public:
 
 	// A PatternRow always starts with the width of whitespace in front of the first black bar.
 	// The first element of the PatternView is the first bar.
-	PatternView(const PatternRow& bars)
-		: _data(bars.data() + 1), _size(Size(bars) - 1), _base(bars.data()), _end(bars.data() + bars.size())
+	// The optional GuardIndex has to be built from the same row, it is passed on to all sub-views.
+	PatternView(const PatternRow& bars, const GuardIndex* guards = nullptr)
+		: _data(bars.data() + 1), _size(Size(bars) - 1), _base(bars.data()), _end(bars.data() + bars.size()), _guards(guards)
 	{}
 
-	PatternView(Iterator data, int size, Iterator base, Iterator end) : _data(data), _size(size), _base(base), _end(end) {}
+	PatternView(Iterator data, int size, Iterator base, Iterator end, const GuardIndex* guards = nullptr)
+		: _data(data), _size(size), _base(base), _end(end), _guards(guards)
+	{}
 
 	template <size_t N>
 	constexpr PatternView(const Pattern<N>& row) : _data(row.data()), _size(N)
@@ -74,6 +80,7 @@ public:
 	bool isValid(int n) const { return _data && _data >= _base && _data + n <= _end; }
 	bool isValid() const { return isValid(size()); }
 	int spaceInFront() const { return isAtFirstBar() ? INT_MAX : _data[-1]; }
+	const GuardIndex* guardIndex() const { return _guards; }
 
 	template<bool acceptIfAtFirstBar = false>
 	bool hasQuietZoneBefore(float scale) const
@@ -96,7 +103,7 @@ public:
 			size = _size - offset;
 		else if (size < 0)
 			size = _size - offset + size;
-		return {begin() + offset, std::max(size, 0), _base, _end};
+		return {begin() + offset, std::max(size, 0), _base, _end, _guards};
 	}
 
 	bool shift(int n)
@@ -264,15 +271,74 @@ bool IsRightGuard(const PatternView& view, const FixedPattern<N, SUM, IS_SPARSE>
 	return IsPattern<E2E>(view, pattern, spaceInPixel, minQuietZone, moduleSizeRef) != 0;
 }
 
+/**
+ * @brief GuardIndex lists the bars of a PatternRow that may start a left guard pattern.
+ *
+ * Most 1D symbologies require a quiet zone in front of their start pattern that is at least some multiple of the
+ * width of its first three bars/spaces. The index is built in a single pass over the row and stores for a few fixed
+ * levels of the ratio (space in front + 1) / (sum of the following 3 elements) all bars reaching that level. All
+ * readers scanning the same row share it and FindLeftGuard() then only visits those bars instead of every one.
+ */
+class GuardIndex
+{
+	// ratio levels as {numerator, denominator} in ascending order
+	static constexpr std::array<std::array<int, 2>, 5> LEVELS = {{{1, 2}, {1, 1}, {5, 4}, {3, 2}, {2, 1}}};
+	std::array<std::vector<int>, LEVELS.size()> _bars; // PatternView::index() of each bar
+
+public:
+	void build(const PatternRow& bars)
+	{
+		for (auto& l : _bars)
+			l.clear();
+		// bars[0] is the space in front of the first bar (index 0), so bar i is bars[i + 1]
+		for (int i = 0, last = Size(bars) - 4; i <= last; i += 2) {
+			int space = bars[i] + 1, sum3 = bars[i + 1] + bars[i + 2] + bars[i + 3];
+			for (int l = 0; l < Size(LEVELS) && space * LEVELS[l][1] >= LEVELS[l][0] * sum3; ++l)
+				_bars[l].push_back(i);
+		}
+	}
+
+	/// Sorted list of all bars that reach minRatio or nullptr if minRatio is below the lowest level.
+	const std::vector<int>* candidates(double minRatio) const
+	{
+		for (int l = Size(LEVELS) - 1; l >= 0; --l)
+			if (LEVELS[l][0] <= minRatio * LEVELS[l][1])
+				return &_bars[l];
+		return nullptr;
+	}
+};
+
+/**
+ * Find the first window of LEN elements in view that satisfies isGuard(window, spaceInPixel) and starts at least
+ * minSize elements before the end of view.
+ *
+ * minQuietZoneRatio is a lower bound for (spaceInPixel + 1) / window.sum(3) of every window that is accepted by
+ * isGuard. If it is given and view has a GuardIndex, only the bars in the index are tested, see GuardIndex.
+ */
 template<int LEN, typename Pred>
-PatternView FindLeftGuard(const PatternView& view, int minSize, Pred isGuard)
+PatternView FindLeftGuard(const PatternView& view, int minSize, Pred isGuard, double minQuietZoneRatio = 0)
 {
+	assert(LEN >= 3 || !minQuietZoneRatio);
+
 	if (view.size() < minSize)
 		return {};
 
 	auto window = view.subView(0, LEN);
 	if (window.isAtFirstBar() && isGuard(window, std::numeric_limits<int>::max()))
 		return window;
+
+	// the index only contains bars, so it can not be used on a view starting with a space
+	auto guards = view.guardIndex();
+	if (auto bars = guards && view.index() % 2 == 0 ? guards->candidates(minQuietZoneRatio) : nullptr) {
+		const int first = view.index(), end = first + view.size() - minSize;
+		for (auto i = std::lower_bound(bars->begin(), bars->end(), first); i != bars->end() && *i < end; ++i) {
+			window = view.subView(*i - first, LEN);
+			if (isGuard(window, window[-1]))
+				return window;
+		}
+		return {};
+	}
+
 	for (auto end = view.end() - minSize; window.data() < end; window.skipPair())
 		if (isGuard(window, window[-1]))
 			return window;
@@ -284,10 +350,14 @@ template <bool E2E = false, int LEN, int SUM, bool IS_SPARSE>
 PatternView FindLeftGuard(const PatternView& view, int minSize, const FixedPattern<LEN, SUM, IS_SPARSE>& pattern,
 						  double minQuietZone)
 {
-	return FindLeftGuard<LEN>(view, std::max(minSize, LEN),
-							  [&pattern, minQuietZone](const PatternView& window, int spaceInPixel) {
-								  return IsPattern<E2E>(window, pattern, spaceInPixel, minQuietZone);
-							  });
+	// IsPattern() rejects every window with spaceInPixel + 1 < minQuietZone * window.sum(LEN) / SUM
+	constexpr bool hasRatio = !E2E && !IS_SPARSE && LEN >= 3;
+	return FindLeftGuard<LEN>(
+		view, std::max(minSize, LEN),
+		[&pattern, minQuietZone](const PatternView& window, int spaceInPixel) {
+			return IsPattern<E2E>(window, pattern, spaceInPixel, minQuietZone);
+		},
+		hasRatio ? minQuietZone / SUM : 0);
 }
 
 template <typename ARRAY, typename = std::enable_if_t<std::is_integral_v<typename ARRAY::value_type>>>
@@ -338,15 +408,44 @@ constexpr std::array<int, RET_LEN> NormalizedE2EPattern(const PatternView& view)
 	return NormalizedE2EPattern<LEN, RET_LEN>(view, SUM);
 }
 
+/**
+ * Packs the normalized edge-to-edge distances with 3 bits each into a key for the direct-index tables built by
+ * PatternsToE2EIndex. Distances outside [2, 9] can not be part of a pattern with elements of 1 to 4 modules and
+ * result in -1.
+ */
+template <size_t N>
+constexpr int E2EKey(const std::array<int, N>& e2e)
+{
+	int key = 0;
+	for (int v : e2e) {
+		if (v < 2 || v > 9)
+			return -1;
+		key = (key << 3) | (v - 2);
+	}
+	return key;
+}
+
+/// Direct-index table from the E2EKey of each pattern to its index in the given list, -1 for all other keys.
 template <int LEN, int SUM, size_t N>
-constexpr auto PatternsToE2EInts(const std::array<FixedPattern<LEN, SUM>, N>& in)
+constexpr auto PatternsToE2EIndex(const std::array<FixedPattern<LEN, SUM>, N>& in)
 {
-	std::array<int, N> res{};
+	static_assert(N <= INT8_MAX, "index does not fit into int8_t");
+	std::array<int8_t, 1 << 3 * (LEN - 2)> res{};
+	for (auto& v : res)
+		v = -1;
 	for (size_t i = 0; i < N; ++i)
-		res[i] = ToInt(NormalizedE2EPattern<LEN, SUM>(in[i]));
+		res[E2EKey(NormalizedE2EPattern<LEN, SUM>(in[i]))] = static_cast<int8_t>(i);
 	return res;
 }
 
+/// Returns the index of the pattern in view via a table built by PatternsToE2EIndex or -1 if there is none.
+template <int LEN, int SUM, size_t N>
+int LookupE2EPattern(const PatternView& view, const std::array<int8_t, N>& index)
+{
+	int key = E2EKey(NormalizedE2EPattern<LEN, SUM>(view));
+	return key == -1 ? -1 : index[key];
+}
+
 template <int LEN, int SUM>
 constexpr std::array<int, LEN> NormalizedPattern(const PatternView& view)
 {
@@ -393,6 +492,15 @@ constexpr std::array<int, LEN> NormalizedPattern(const PatternView& view)
 	return is;
 }
 
+/**
+ * Add the run lengths of the bytes in [begin, end) to the PatternRow being built at res, see GetPatternRow.
+ *
+ * *res is the length of the current run so far, every change in value finishes a run and advances res. Uses
+ * SSE2/AVX2 or NEON code selected at runtime and returns the first byte that was not processed, at most 32 bytes
+ * before end, or begin if no SIMD support is available.
+ */
+const uint8_t* AddRunLengths(const uint8_t* begin, const uint8_t* end, PatternType*& res);
+
 template<typename I>
 void GetPatternRow(Range<I> b_row, PatternRow& p_row)
 {
@@ -435,6 +543,10 @@ void GetPatternRow(Range<I> b_row, PatternRow& p_row)
 		const auto* const bitPtrEnd = std::to_address(bitPosEnd);
 		auto* bitPtr = bitPtrBegin;
 
+		// process the bulk of the row with SSE2/AVX2 or NEON code, the 64 bit loop below handles the remainder
+		auto bytePtr = reinterpret_cast<const uint8_t*>(bitPtrBegin);
+		bitPtr += AddRunLengths(bytePtr, bytePtr + (bitPtrEnd - bitPtrBegin), intPos) - bytePtr;
+
 		while (bitPtr < bitPtrEnd - sizeof(simd_t)) {
 			auto asSimd0 = LoadU<simd_t>(bitPtr);
 			auto asSimd1 = LoadU<simd_t>(bitPtr + 1);
@@ -4,9 +4,11 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "ReadBarcode.h"
+#include "ReaderContext.h"
 #include "ReaderOptions.h"
 #include "BarcodeData.h"
 #include "Version.h"
+#include "ZXAlgorithms.h"
 
 #include <utility>
 
@@ -14,13 +16,19 @@
 #ifdef ZXING_READERS
 #include "GlobalHistogramBinarizer.h"
 #include "HybridBinarizer.h"
+#include "LumImage.h"
 #include "MultiFormatReader.h"
+#include "ParallelFor.h"
 #include "Pattern.h"
 #include "ThresholdBinarizer.h"
 #endif
 
+#include <atomic>
+#include <chrono>
 #include <climits>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
 
 namespace ZXing {
@@ -41,14 +49,19 @@ struct ReaderOptions::Data
 	bool isPure                   : 1 = false;
 	bool validateOptionalChecksum : 1 = false;
 	bool returnErrors             : 1 = false;
+	bool accumulateStackedRows    : 1 = false;
+	bool hasMaxThreads            : 1 = false;
 	uint8_t downscaleFactor       : 3 = 3; // values 2, 3, 4
 	EanAddOnSymbol eanAddOnSymbol : 2 = EanAddOnSymbol::Ignore;
 	Binarizer binarizer           : 2 = Binarizer::LocalAverage;
+	RowScan rowScan               : 1 = RowScan::MiddleOut;
 	TextMode textMode             : 3 = TextMode::HRI;
 	CharacterSet characterSet     : 6 = CharacterSet::Unknown;
 
 	uint8_t minLineCount          = 2;
 	uint8_t maxNumberOfSymbols    = 0xff;
+	uint8_t maxThreads            = 1;
+	Executor* executor            = nullptr;
 	uint16_t downscaleThreshold   = 500;
 	BarcodeFormats formats        = {};
 };
@@ -90,7 +103,10 @@ ZX_PROPERTY(bool, isPure, setIsPure)
 ZX_PROPERTY(uint16_t, downscaleThreshold, setDownscaleThreshold)
 ZX_PROPERTY(uint8_t, downscaleFactor, setDownscaleFactor)
 ZX_PROPERTY(uint8_t, minLineCount, setMinLineCount)
+ZX_PROPERTY(RowScan, rowScan, setRowScan)
+ZX_PROPERTY(bool, accumulateStackedRows, setAccumulateStackedRows)
 ZX_PROPERTY(uint8_t, maxNumberOfSymbols, setMaxNumberOfSymbols)
+ZX_PROPERTY(Executor*, executor, setExecutor)
 ZX_PROPERTY(bool, validateOptionalChecksum, setValidateOptionalChecksum)
 ZX_PROPERTY(bool, returnErrors, setReturnErrors)
 ZX_PROPERTY(EanAddOnSymbol, eanAddOnSymbol, setEanAddOnSymbol)
@@ -99,6 +115,20 @@ ZX_PROPERTY(CharacterSet, characterSet, setCharacterSet)
 
 #undef ZX_PROPERTY
 
+uint8_t ReaderOptions::maxThreads() const noexcept { return d->maxThreads; }
+ReaderOptions& ReaderOptions::maxThreads(uint8_t v) &
+{
+	d->maxThreads = v;
+	d->hasMaxThreads = true;
+	return *this;
+}
+ReaderOptions&& ReaderOptions::maxThreads(uint8_t v) &&
+{
+	d->maxThreads = v;
+	d->hasMaxThreads = true;
+	return std::move(*this);
+}
+
 ReaderOptions& ReaderOptions::characterSet(std::string_view v) &
 {
 	d->characterSet = CharacterSetFromString(v);
@@ -120,54 +150,56 @@ bool ReaderOptions::hasAnyFormat(const BarcodeFormats& formats) const noexcept
 	return d->formats.empty() || std::any_of(formats.begin(), formats.end(), [this](BarcodeFormat bt) { return bt & d->formats; });
 }
 
-// ==============================================================================
-// ReadBarcode implementation
-// ==============================================================================
-
-#ifdef ZXING_READERS
-
-class LumImage : public Image
+bool ReaderOptions::hasMaxThreads() const noexcept
 {
-public:
-	using Image::Image;
-
-	uint8_t* data() { return const_cast<uint8_t*>(Image::data()); }
-};
-
-template<typename P>
-static LumImage ExtractLum(const ImageView& iv, P projection)
-{
-	LumImage res(iv.width(), iv.height());
-
-	auto* dst = res.data();
-	for(int y = 0; y < iv.height(); ++y)
-		for(int x = 0, w = iv.width(); x < w; ++x)
-			*dst++ = projection(iv.data(x, y));
-
-	return res;
+	return d->hasMaxThreads;
 }
 
+#ifdef ZXING_READERS
+
 class LumImagePyramid
 {
-	std::vector<LumImage> buffers;
+public:
+	struct Layer
+	{
+		ImageView iv;
+		LumImage buffer;
+		Matrix<uint8_t> blockThresholds; // of the HybridBinarizer, collected while downscaling
+	};
+
+private:
+	std::vector<Layer> _layers; // kept by reset() to reuse the buffers, references stay valid until then
+	std::mutex _mutex;
+	int _size = 0;
+	int _built = 0;
+	int _factor = 0;
+	bool _withBlockThresholds = false;
 
 	template<int N>
 	void addLayer()
 	{
-		auto siv = layers.back();
-		buffers.emplace_back(siv.width() / N, siv.height() / N);
-		layers.push_back(buffers.back());
-		auto& div = buffers.back();
-		auto* d   = div.data();
+		const ImageView siv = _layers[_built - 1].iv;
+		auto& layer = _layers[_built++];
+		layer.buffer.resize(siv.width() / N, siv.height() / N);
+		layer.iv = layer.buffer;
+		auto& div = layer.buffer;
+
+		// fuse the block statistics of the binarizer into the downscaling pass, each row is still in the cache
+		BlockThresholdsBuilder blockThresholds(_withBlockThresholds ? div.width() : 0, div.height());
 
-		for (int dy = 0; dy < div.height(); ++dy)
+		for (int dy = 0; dy < div.height(); ++dy) {
+			auto* d = div.data() + dy * div.width();
 			for (int dx = 0; dx < div.width(); ++dx) {
 				int sum = (N * N) / 2;
 				for (int ty = 0; ty < N; ++ty)
 					for (int tx = 0; tx < N; ++tx)
 						sum += *siv.data(dx * N + tx, dy * N + ty);
-				*d++ = sum / (N * N);
+				d[dx] = sum / (N * N);
 			}
+			blockThresholds.addRow(dy, d);
+		}
+
+		layer.blockThresholds = blockThresholds.thresholds();
 	}
 
 	void addLayer(int factor)
@@ -182,54 +214,58 @@ class LumImagePyramid
 	}
 
 public:
-	std::vector<ImageView> layers;
-
-	LumImagePyramid(const ImageView& iv, int threshold, int factor)
+	/// Start over with a new base image, the buffers of the layers of the previous one are reused.
+	void reset(const ImageView& iv, int threshold, int factor, bool withBlockThresholds)
 	{
 		if (factor < 2)
 			throw std::invalid_argument("Invalid ReaderOptions::downscaleFactor");
 
-		layers.push_back(iv);
+		_factor = factor;
+		_withBlockThresholds = withBlockThresholds;
+
+		// only count the layers here, most images are successfully read before the smaller ones are needed
 		// TODO: if only matrix codes were considered, then using std::min would be sufficient (see #425)
-		while (threshold > 0 && std::max(layers.back().width(), layers.back().height()) > threshold &&
-			   std::min(layers.back().width(), layers.back().height()) >= factor)
-			addLayer(factor);
-#if 0
-		// Reversing the layers means we'd start with the smallest. that can make sense if we are only looking for a
-		// single symbol. If we start with the higher resolution, we get better (high res) position information.
-		// TODO: see if masking out higher res layers based on found symbols in lower res helps overall performance.
-		std::reverse(layers.begin(), layers.end());
-#endif
+		_size = 1;
+		for (int w = iv.width(), h = iv.height(); threshold > 0 && std::max(w, h) > threshold && std::min(w, h) >= factor;
+			 w /= factor, h /= factor)
+			++_size;
+
+		if (Size(_layers) < _size)
+			_layers.resize(_size);
+		_layers[0].iv = iv;
+		_built = 1;
+	}
+
+	int size() const { return _size; }
+
+	/// Returns layer i, the layers up to i are built on first access. Can be called concurrently.
+	const Layer& operator[](int i)
+	{
+		std::scoped_lock lock(_mutex);
+		while (_built <= i)
+			addLayer(_factor);
+		return _layers[i];
 	}
 };
 
-ImageView SetupLumImageView(ImageView iv, LumImage& lum, const ReaderOptions& opts)
+static ImageView SetupLumImageView(ImageView iv, LumImage& lum, const ReaderOptions& opts)
 {
 	if (iv.format() == ImageFormat::None)
 		throw std::invalid_argument("Invalid image format");
 
 	if (opts.binarizer() == Binarizer::GlobalHistogram || opts.binarizer() == Binarizer::LocalAverage) {
-		// manually spell out the 3 most common pixel formats to get at least gcc to vectorize the code
-		if (iv.format() == ImageFormat::RGB && iv.pixStride() == 3) {
-			lum = ExtractLum(iv, [](const uint8_t* src) { return RGBToLum(src[0], src[1], src[2]); });
-		} else if (iv.format() == ImageFormat::RGBA && iv.pixStride() == 4) {
-			lum = ExtractLum(iv, [](const uint8_t* src) { return RGBToLum(src[0], src[1], src[2]); });
-		} else if (iv.format() == ImageFormat::BGR && iv.pixStride() == 3) {
-			lum = ExtractLum(iv, [](const uint8_t* src) { return RGBToLum(src[2], src[1], src[0]); });
-		} else if (iv.format() != ImageFormat::Lum) {
-			lum = ExtractLum(iv, [r = RedIndex(iv.format()), g = GreenIndex(iv.format()), b = BlueIndex(iv.format())](
-									 const uint8_t* src) { return RGBToLum(src[r], src[g], src[b]); });
-		} else if (iv.pixStride() != 1) {
-			// GlobalHistogram and LocalAverage need dense line memory layout
-			lum = ExtractLum(iv, [](const uint8_t* src) { return *src; });
-		}
-		if (lum.data())
-			return lum;
+		const int r = RedIndex(iv.format());
+		// luminance-only formats (e.g. LumA or UYVY) are processed in place, skipping the other bytes via pixStride
+		if (r == GreenIndex(iv.format()) && r == BlueIndex(iv.format()))
+			return {iv.data() + r, iv.width(), iv.height(), ImageFormat::Lum, iv.rowStride(), iv.pixStride()};
+
+		ExtractLum(iv, lum);
+		return lum;
 	}
 	return iv;
 }
 
-std::unique_ptr<BinaryBitmap> CreateBitmap(ZXing::Binarizer binarizer, const ImageView& iv)
+static std::unique_ptr<BinaryBitmap> CreateBitmap(ZXing::Binarizer binarizer, const ImageView& iv)
 {
 	switch (binarizer) {
 	case Binarizer::BoolCast: return std::make_unique<ThresholdBinarizer>(iv, 0);
@@ -240,69 +276,362 @@ std::unique_ptr<BinaryBitmap> CreateBitmap(ZXing::Binarizer binarizer, const Ima
 	return {}; // silence gcc warning
 }
 
-Barcode ReadBarcode(const ImageView& _iv, const ReaderOptions& opts)
+// ==============================================================================
+// ReaderContext implementation
+// ==============================================================================
+
+struct ReaderContext::Data
+{
+	ReaderOptions opts;
+	MultiFormatReader reader; // references opts
+#ifdef ZXING_EXPERIMENTAL_API
+	ReaderOptions closedOptions;
+#endif
+	std::unique_ptr<MultiFormatReader> closedReader;
+
+	// buffers reused across read() calls, one set per region of interest that is processed concurrently
+	struct Scratch
+	{
+		LumImage lum;
+		LumImagePyramid pyramid;
+	};
+	std::vector<std::unique_ptr<Scratch>> scratch;
+	BitMatrixPool matrixPool;
+	// single threaded copies of this context that read the images of a batch, one per thread, created on demand
+	std::vector<std::unique_ptr<Data>> batchReaders;
+
+	// stops reading an image between two passes once the batch is cancelled or the deadline of the image has passed
+	struct Interrupt
+	{
+		const CancellationToken* cancel;
+		std::chrono::steady_clock::time_point deadline;
+		bool triggered = false;
+
+		bool operator()()
+		{
+			return triggered = triggered || (cancel && cancel->isCancelled()) || std::chrono::steady_clock::now() > deadline;
+		}
+	};
+
+	explicit Data(const ReaderOptions& o) : opts(o), reader(opts)
+	{
+		scratch.push_back(std::make_unique<Scratch>());
+#ifdef ZXING_EXPERIMENTAL_API
+		using enum BarcodeFormat;
+		BarcodeFormats formatsBenefittingFromClosing = Aztec | DataMatrix | QRCode;
+		if (opts.tryDenoise() && opts.hasAnyFormat(formatsBenefittingFromClosing)) {
+			closedOptions = opts;
+			closedOptions.formats(opts.formats().empty() ? formatsBenefittingFromClosing
+														 : formatsBenefittingFromClosing & opts.formats());
+			closedReader = std::make_unique<MultiFormatReader>(closedOptions);
+		}
+#endif
+	}
+
+	std::unique_ptr<BinaryBitmap> createBitmap(const ImageView& iv)
+	{
+		auto res = CreateBitmap(opts.binarizer(), iv);
+		res->setMatrixPool(&matrixPool);
+		return res;
+	}
+
+	std::unique_ptr<BinaryBitmap> createBitmap(const LumImagePyramid::Layer& layer)
+	{
+		std::unique_ptr<BinaryBitmap> res;
+		if (opts.binarizer() == Binarizer::LocalAverage && layer.blockThresholds.size())
+			res = std::make_unique<HybridBinarizer>(layer.iv, layer.blockThresholds.copy());
+		else
+			res = CreateBitmap(opts.binarizer(), layer.iv);
+		res->setConcurrency(opts.executor(), opts.maxThreads());
+		res->setMatrixPool(&matrixPool);
+		return res;
+	}
+
+	// each read() call is one frame for the readers that keep state across calls, see accumulateStackedRows()
+	void newFrame()
+	{
+		reader.newFrame();
+		if (closedReader)
+			closedReader->newFrame();
+	}
+
+	Barcodes read(const ImageView& iv, Scratch& scratch, Interrupt* interrupt = nullptr);
+	Barcodes read(const ImageView& iv, const std::vector<Position>& rois);
+	std::vector<BatchResult> read(const std::vector<ImageView>& images, Executor& executor, const CancellationToken* cancel,
+								  std::chrono::milliseconds timeout);
+};
+
+ReaderContext::ReaderContext(const ReaderOptions& options) : d(std::make_unique<Data>(options)) {}
+ReaderContext::~ReaderContext() = default;
+
+ReaderContext::ReaderContext(ReaderContext&&) noexcept = default;
+ReaderContext& ReaderContext::operator=(ReaderContext&&) noexcept = default;
+
+const ReaderOptions& ReaderContext::options() const
+{
+	return d->opts;
+}
+
+Barcodes ReaderContext::read(const ImageView& image)
+{
+	d->newFrame();
+	return d->read(image, *d->scratch.front());
+}
+
+Barcodes ReaderContext::read(const ImageView& image, const std::vector<Position>& rois)
+{
+	d->newFrame();
+	return d->read(image, rois);
+}
+
+Barcodes ReaderContext::readAgain(const ImageView& image)
+{
+	return d->read(image, *d->scratch.front());
+}
+
+std::vector<BatchResult> ReaderContext::read(const std::vector<ImageView>& images, Executor& executor,
+											 const CancellationToken* cancel, std::chrono::milliseconds timeout)
 {
-	return FirstOrDefault(ReadBarcodes(_iv, ReaderOptions(opts).maxNumberOfSymbols(1)));
+	return d->read(images, executor, cancel, timeout);
 }
 
-Barcodes ReadBarcodes(const ImageView& _iv, const ReaderOptions& opts)
+static void CheckImage(const ImageView& iv)
 {
-	if (sizeof(PatternType) < 4 && (_iv.width() > 0xffff || _iv.height() > 0xffff))
+	if (sizeof(PatternType) < 4 && (iv.width() > 0xffff || iv.height() > 0xffff))
 		throw std::invalid_argument("Maximum image width/height is 65535");
 
-	if (!_iv.data() || _iv.width() * _iv.height() == 0)
+	if (!iv.data() || iv.width() * iv.height() == 0)
 		throw std::invalid_argument("ImageView is null/empty");
+}
 
-	LumImage lum;
-	ImageView iv = SetupLumImageView(_iv, lum, opts);
-	MultiFormatReader reader(opts);
+// Returns the bounding boxes of the rois, clipped to the image and with overlapping ones merged
+static std::vector<Position> MergedRegions(const ImageView& iv, const std::vector<Position>& rois)
+{
+	std::vector<Position> res;
+	for (const auto& roi : rois) {
+		auto bb = BoundingBox(roi);
+		PointI tl = {std::max(bb.topLeft().x, 0), std::max(bb.topLeft().y, 0)};
+		PointI br = {std::min(bb.bottomRight().x, iv.width() - 1), std::min(bb.bottomRight().y, iv.height() - 1)};
+		if (tl.x > br.x || tl.y > br.y)
+			continue;
+
+		// a merged region may overlap with regions it did not overlap with before, so start over after each merge
+		for (auto i = res.begin(); i != res.end();) {
+			if (HaveIntersectingBoundingBoxes(*i, Position{tl, {br.x, tl.y}, br, {tl.x, br.y}})) {
+				tl = {std::min(tl.x, i->topLeft().x), std::min(tl.y, i->topLeft().y)};
+				br = {std::max(br.x, i->bottomRight().x), std::max(br.y, i->bottomRight().y)};
+				res.erase(i);
+				i = res.begin();
+			} else {
+				++i;
+			}
+		}
+		res.push_back({tl, {br.x, tl.y}, br, {tl.x, br.y}});
+	}
+	return res;
+}
 
-	if (opts.isPure())
-		return {FirstOrDefault(reader.read(*CreateBitmap(opts.binarizer(), iv), 1)).setReaderOptions(opts)};
+Barcodes ReaderContext::Data::read(const ImageView& iv, const std::vector<Position>& rois)
+{
+	CheckImage(iv);
+
+	// only the regions are converted to luminance and binarized, they are cropped before the setup of read()
+	auto regions = MergedRegions(iv, rois);
+	int maxThreads = ResolveMaxThreads(opts.maxThreads());
+	if (Size(regions) < 2)
+		maxThreads = 1;
+	while (Size(scratch) < (maxThreads == 1 ? 1 : Size(regions)))
+		scratch.push_back(std::make_unique<Scratch>());
+
+	std::vector<Barcodes> results(regions.size());
+	auto readRegion = [&](int i) {
+		auto tl = regions[i].topLeft(), br = regions[i].bottomRight();
+		auto crop = iv.cropped(tl.x, tl.y, br.x - tl.x + 1, br.y - tl.y + 1);
+		auto& rs = results[i] = read(crop, *scratch[maxThreads == 1 ? 0 : i]);
+		for (auto& r : rs)
+			r.d->position = Move(r.position(), tl);
+	};
 
-	std::unique_ptr<MultiFormatReader> closedReader;
-#ifdef ZXING_EXPERIMENTAL_API
-	using enum BarcodeFormat;
-	BarcodeFormats formatsBenefittingFromClosing = Aztec | DataMatrix | QRCode;
-	ReaderOptions closedOptions = opts;
-	if (opts.tryDenoise() && opts.hasAnyFormat(formatsBenefittingFromClosing) && _iv.height() >= 3) {
-		closedOptions.formats(opts.formats().empty() ? formatsBenefittingFromClosing : formatsBenefittingFromClosing & opts.formats());
-		closedReader = std::make_unique<MultiFormatReader>(closedOptions);
+	Barcodes res;
+	int maxSymbols = opts.maxNumberOfSymbols() ? opts.maxNumberOfSymbols() : INT_MAX;
+	auto merge = [&](Barcodes&& rs) {
+		for (auto& r : rs)
+			if (Size(res) < maxSymbols && !Contains(res, r))
+				res.push_back(std::move(r));
+		return Size(res) >= maxSymbols;
+	};
+
+	if (maxThreads == 1) {
+		for (int i = 0; i < Size(regions); ++i) {
+			readRegion(i);
+			if (merge(std::move(results[i])))
+				break;
+		}
+	} else {
+		ParallelFor(opts.executor(), maxThreads, Size(regions), readRegion);
+		for (auto& rs : results)
+			if (merge(std::move(rs)))
+				break;
 	}
-#endif
-	LumImagePyramid pyramid(iv, opts.downscaleThreshold() * opts.tryDownscale(), opts.downscaleFactor());
+
+	return res;
+}
+
+std::vector<BatchResult> ReaderContext::Data::read(const std::vector<ImageView>& images, Executor& executor,
+												   const CancellationToken* cancel, std::chrono::milliseconds timeout)
+{
+	for (const auto& iv : images)
+		CheckImage(iv);
+
+	// Every thread takes a reader with its own buffers and reader state when it starts reading an image and returns it
+	// afterwards. The parallelism is over the images, reading each one with multiple threads as well would only add
+	// overhead. The images are unrelated, so the stacked rows of one must not be combined with the ones of another.
+	std::mutex mutex;
+	std::vector<Data*> idle;
+	for (auto& d : batchReaders)
+		idle.push_back(d.get());
+
+	auto takeReader = [&] {
+		std::scoped_lock lock(mutex);
+		if (idle.empty()) {
+			batchReaders.push_back(std::make_unique<Data>(ReaderOptions(opts).maxThreads(1).accumulateStackedRows(false)));
+			return batchReaders.back().get();
+		}
+		auto* d = idle.back();
+		idle.pop_back();
+		return d;
+	};
+
+	// the executor was passed explicitly, so it is used to its full concurrency unless maxThreads() was set as a limit
+	int maxThreads = executor.concurrency() + 1;
+	if (opts.hasMaxThreads())
+		maxThreads = std::min(maxThreads, ResolveMaxThreads(opts.maxThreads()));
+
+	std::vector<BatchResult> res(images.size());
+	ParallelFor(&executor, maxThreads, Size(images), [&](int i) {
+		using Clock = std::chrono::steady_clock;
+		Interrupt interrupt{cancel, timeout.count() > 0 ? Clock::now() + timeout : Clock::time_point::max()};
+		if (!interrupt()) {
+			auto* d = takeReader();
+			res[i].barcodes = d->read(images[i], *d->scratch.front(), &interrupt);
+			std::scoped_lock lock(mutex);
+			idle.push_back(d);
+		}
+		if (interrupt.triggered)
+			res[i].status = cancel && cancel->isCancelled() ? BatchResult::Status::Cancelled : BatchResult::Status::TimedOut;
+	});
+
+	return res;
+}
+
+Barcodes ReaderContext::Data::read(const ImageView& _iv, Scratch& scratch, Interrupt* interrupt)
+{
+	CheckImage(_iv);
+
+	auto& pyramid = scratch.pyramid;
+	ImageView iv = SetupLumImageView(_iv, scratch.lum, opts);
+
+	if (opts.isPure())
+		return {FirstOrDefault(reader.read(*createBitmap(iv), 1)).setReaderOptions(opts)};
+
+	const bool tryClose = closedReader && _iv.height() >= 3;
+
+	pyramid.reset(iv, opts.downscaleThreshold() * opts.tryDownscale(), opts.downscaleFactor(),
+				  opts.binarizer() == Binarizer::LocalAverage);
 
 	Barcodes res;
 	int maxSymbols = opts.maxNumberOfSymbols() ? opts.maxNumberOfSymbols() : INT_MAX;
-	for (auto&& iv : pyramid.layers) {
-		auto bitmap = CreateBitmap(opts.binarizer(), iv);
-		for (int close = 0; close <= (closedReader ? 1 : 0); ++close) {
-			if (close) {
-				// if we already inverted the image in the first round, we need to undo that first
-				if (bitmap->inverted())
-					bitmap->invert();
-				bitmap->close();
+
+	// returns true if we found enough symbols to stop looking
+	auto merge = [&](Barcodes&& rs, const ImageView& iv, bool inverted) {
+		for (auto& r : rs) {
+			if (iv.width() != _iv.width())
+				r.d->position = Scale(r.position(), _iv.width() / iv.width());
+			if (!Contains(res, r)) {
+				r.setReaderOptions(opts);
+				r.d->isInverted = inverted;
+				res.push_back(std::move(r));
+				--maxSymbols;
 			}
+		}
+		return maxSymbols <= 0;
+	};
+
+	int maxThreads = ResolveMaxThreads(opts.maxThreads());
+
+	if (maxThreads == 1) {
+		for (int i = 0; i < pyramid.size(); ++i) {
+			auto& layer = pyramid[i];
+			const auto& iv = layer.iv;
+			auto bitmap = createBitmap(layer);
+			for (int close = 0; close <= static_cast<int>(tryClose); ++close) {
+				if (close) {
+					// if we already inverted the image in the first round, we need to undo that first
+					if (bitmap->inverted())
+						bitmap->invert();
+					bitmap->close();
+				}
 
-			// TODO: check if closing after invert would be beneficial
-			for (int invert = 0; invert <= static_cast<int>(opts.tryInvert() && !close); ++invert) {
-				if (invert)
-					bitmap->invert();
-				auto rs = (close ? *closedReader : reader).read(*bitmap, maxSymbols);
-				for (auto& r : rs) {
-					if (iv.width() != _iv.width())
-						r.d->position = Scale(r.position(), _iv.width() / iv.width());
-					if (!Contains(res, r)) {
-						r.setReaderOptions(opts);
-						r.d->isInverted = bitmap->inverted();
-						res.push_back(std::move(r));
-						--maxSymbols;
-					}
+				// TODO: check if closing after invert would be beneficial
+				for (int invert = 0; invert <= static_cast<int>(opts.tryInvert() && !close); ++invert) {
+					if (interrupt && (*interrupt)())
+						return res;
+					if (invert)
+						bitmap->invert();
+					if (merge((close ? *closedReader : reader).read(*bitmap, maxSymbols), iv, bitmap->inverted()))
+						return res;
 				}
-				if (maxSymbols <= 0)
-					return res;
 			}
 		}
+	} else {
+		// Every layer/variant combination gets its own bitmap, so they can be processed independently. The results
+		// are merged strictly in the order of the serial loop above, so the outcome does not depend on the scheduling.
+		// The layers are built on demand, so the smaller ones are skipped if enough symbols are found before.
+		struct Pass
+		{
+			int layer;
+			bool invert, close;
+			const ImageView* iv = nullptr;
+			std::optional<Barcodes> res = {};
+		};
+		std::vector<Pass> passes;
+		for (int i = 0; i < pyramid.size(); ++i) {
+			passes.push_back({i, false, false});
+			if (opts.tryInvert())
+				passes.push_back({i, true, false});
+			if (tryClose)
+				passes.push_back({i, false, true});
+		}
+
+		const int maxSymbolsPerPass = maxSymbols;
+		std::mutex mutex;
+		int merged = 0;
+		std::atomic<bool> done = false;
+
+		ParallelFor(opts.executor(), maxThreads, Size(passes), [&](int i) {
+			if (done)
+				return;
+			auto& pass = passes[i];
+			auto& layer = pyramid[pass.layer];
+			pass.iv = &layer.iv;
+			auto bitmap = createBitmap(layer);
+			if (pass.invert || pass.close) {
+				bitmap->getBitMatrix(); // invert() and close() operate on the cached BitMatrix
+				pass.invert ? bitmap->invert() : bitmap->close();
+			}
+			auto rs = (pass.close ? *closedReader : reader).read(*bitmap, maxSymbolsPerPass);
+
+			std::scoped_lock lock(mutex);
+			pass.res = std::move(rs);
+			for (; !done && merged < Size(passes) && passes[merged].res; ++merged)
+				done = merge(std::move(*passes[merged].res), *passes[merged].iv, passes[merged].invert);
+		});
+
+		if (done) {
+			// passes running concurrently may have returned more symbols than the serial loop would have looked for
+			res.resize(std::min(Size(res), maxSymbolsPerPass));
+			return res;
+		}
 	}
 
 	if (opts.returnErrors()) {
@@ -320,16 +649,69 @@ Barcodes ReadBarcodes(const ImageView& _iv, const ReaderOptions& opts)
 
 #else // ZXING_READERS
 
-Barcode ReadBarcode(const ImageView&, const ReaderOptions&)
+struct ReaderContext::Data
+{
+	ReaderOptions opts;
+};
+
+ReaderContext::ReaderContext(const ReaderOptions& options) : d(std::make_unique<Data>(options)) {}
+ReaderContext::~ReaderContext() = default;
+
+ReaderContext::ReaderContext(ReaderContext&&) noexcept = default;
+ReaderContext& ReaderContext::operator=(ReaderContext&&) noexcept = default;
+
+const ReaderOptions& ReaderContext::options() const
+{
+	return d->opts;
+}
+
+Barcodes ReaderContext::read(const ImageView&)
+{
+	throw std::runtime_error("This build of zxing-cpp does not support reading barcodes.");
+}
+
+Barcodes ReaderContext::read(const ImageView&, const std::vector<Position>&)
+{
+	throw std::runtime_error("This build of zxing-cpp does not support reading barcodes.");
+}
+
+Barcodes ReaderContext::readAgain(const ImageView&)
 {
 	throw std::runtime_error("This build of zxing-cpp does not support reading barcodes.");
 }
 
-Barcodes ReadBarcodes(const ImageView&, const ReaderOptions&)
+std::vector<BatchResult> ReaderContext::read(const std::vector<ImageView>&, Executor&, const CancellationToken*,
+											 std::chrono::milliseconds)
 {
 	throw std::runtime_error("This build of zxing-cpp does not support reading barcodes.");
 }
 
 #endif // ZXING_READERS
 
+// ==============================================================================
+// ReadBarcode implementation
+// ==============================================================================
+
+Barcode ReadBarcode(const ImageView& iv, const ReaderOptions& opts)
+{
+	return FirstOrDefault(ReadBarcodes(iv, ReaderOptions(opts).maxNumberOfSymbols(1)));
+}
+
+Barcodes ReadBarcodes(const ImageView& iv, const ReaderOptions& opts)
+{
+	return ReaderContext(opts).read(iv);
+}
+
+Barcodes ReadBarcodes(const ImageView& iv, const std::vector<Position>& rois, const ReaderOptions& opts)
+{
+	return ReaderContext(opts).read(iv, rois);
+}
+
+std::vector<BatchResult> ReadBarcodesBatch(const std::vector<ImageView>& images, const ReaderOptions& opts,
+										   Executor& executor, const CancellationToken* cancel,
+										   std::chrono::milliseconds timeout)
+{
+	return ReaderContext(opts).read(images, executor, cancel, timeout);
+}
+
 } // ZXing
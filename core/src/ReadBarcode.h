@@ -9,6 +9,10 @@
 #include "ImageView.h"
 #include "Barcode.h"
 
+#include <atomic>
+#include <chrono>
+#include <vector>
+
 namespace ZXing {
 
 /**
@@ -29,5 +33,70 @@ Barcode ReadBarcode(const ImageView& image, const ReaderOptions& options = {});
  */
 Barcodes ReadBarcodes(const ImageView& image, const ReaderOptions& options = {});
 
+/**
+ * Read barcodes from regions of interest of an ImageView, e.g. found by an object detector
+ *
+ * Only the pixels inside the regions are processed. Overlapping regions are merged into their bounding box, so
+ * that symbols crossing their border are found as well. The regions are processed concurrently if
+ * ReaderOptions::maxThreads() allows it.
+ *
+ * @param image  view of the image data including layout and format
+ * @param rois  regions of interest in image coordinates, the bounding box of each one is used
+ * @param options  ReaderOptions to parameterize / speed up detection (required, so ReadBarcodes(image, {}) stays unambiguous)
+ * @return List of Barcode found, in the order of the regions and with their position in image coordinates
+ */
+Barcodes ReadBarcodes(const ImageView& image, const std::vector<Position>& rois, const ReaderOptions& options);
+
+/**
+ * @brief Lets another thread stop a running ReadBarcodesBatch().
+ */
+class CancellationToken
+{
+	std::atomic<bool> _cancelled = false;
+
+public:
+	void cancel() noexcept { _cancelled.store(true, std::memory_order_relaxed); }
+	bool isCancelled() const noexcept { return _cancelled.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Barcodes found in one image of a batch, see ReadBarcodesBatch().
+ */
+struct BatchResult
+{
+	enum class Status
+	{
+		Complete,  ///< the image was read completely
+		TimedOut,  ///< the time budget of the image was used up, barcodes contains what was found until then
+		Cancelled, ///< the batch was cancelled before or while the image was read
+	};
+
+	Barcodes barcodes;
+	Status status = Status::Complete;
+};
+
+/**
+ * Read barcodes from a batch of images
+ *
+ * The images are distributed dynamically over the threads of the executor and the calling one. Their number is only
+ * limited by ReaderOptions::maxThreads() if that was set explicitly, 1 reads them one after the other on the calling
+ * thread. Every image is read by a single thread, which reuses its intermediate image buffers for the next image it
+ * takes. The images are unrelated, so ReaderOptions::accumulateStackedRows() is ignored. All images are validated
+ * before the first one is read, an invalid one throws std::invalid_argument like ReadBarcodes().
+ *
+ * Cancellation and timeouts take effect between the passes over an image (e.g. the inverted or downscaled
+ * variants), so a single pass is never interrupted.
+ *
+ * @param images  views of the image data including layout and format
+ * @param options  ReaderOptions to parameterize / speed up detection, ReaderOptions::executor() is ignored
+ * @param executor  provides the additional threads, e.g. a ThreadPool that is shared with the rest of the application
+ * @param cancel  optional token to stop reading the images that are not finished yet
+ * @param timeout  time budget of each image, counted from the moment its reading starts, 0 means none
+ * @return One BatchResult per image, in the order of the images
+ */
+std::vector<BatchResult> ReadBarcodesBatch(const std::vector<ImageView>& images, const ReaderOptions& options,
+										   Executor& executor, const CancellationToken* cancel = nullptr,
+										   std::chrono::milliseconds timeout = {});
+
 } // ZXing
 
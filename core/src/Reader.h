@@ -27,6 +27,10 @@ public:
 	virtual ~Reader() = default;
 
 	virtual BarcodesData read(const BinaryBitmap& image, int maxSymbols) const = 0;
+
+	/// Called by a ReaderContext before each frame (read() call), for readers that keep state across frames (see
+	/// ReaderOptions::accumulateStackedRows()).
+	virtual void newFrame() {}
 };
 
 } // ZXing
@@ -0,0 +1,62 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "Barcode.h"
+#include "ImageView.h"
+#include "ReadBarcode.h"
+#include "ReaderOptions.h"
+
+#include <memory>
+
+namespace ZXing {
+
+/**
+ * @brief Reads barcodes from a series of images with the same ReaderOptions.
+ *
+ * ReadBarcodes() sets up the format specific readers and allocates the intermediate images (luminance,
+ * downscaled and binarized versions of the input) for every call. A ReaderContext keeps all of those across calls,
+ * so reading e.g. the frames of a video stream does not allocate the image buffers again once their sizes are
+ * known. The results are the same as those of ReadBarcodes().
+ *
+ * A ReaderContext must not be used from multiple threads at the same time, use one instance per thread instead.
+ */
+class ReaderContext
+{
+	struct Data;
+	std::unique_ptr<Data> d;
+
+public:
+	explicit ReaderContext(const ReaderOptions& options = {});
+	~ReaderContext();
+
+	ReaderContext(ReaderContext&&) noexcept;
+	ReaderContext& operator=(ReaderContext&&) noexcept;
+
+	const ReaderOptions& options() const;
+
+	/**
+	 * Read barcodes from an ImageView
+	 *
+	 * @param image  view of the image data including layout and format
+	 * @return List of Barcode found, may be empty
+	 */
+	Barcodes read(const ImageView& image);
+
+	/// Read barcodes from regions of interest of an ImageView, see the corresponding ReadBarcodes() overload.
+	Barcodes read(const ImageView& image, const std::vector<Position>& rois);
+
+	/// Read barcodes from a batch of images, see ReadBarcodesBatch(). The per thread buffers are kept for the next batch.
+	std::vector<BatchResult> read(const std::vector<ImageView>& images, Executor& executor,
+								  const CancellationToken* cancel = nullptr, std::chrono::milliseconds timeout = {});
+
+private:
+	friend class BarcodeTracker;
+	// read() the image again as part of the same frame, e.g. the full scan after the search windows of a BarcodeTracker
+	Barcodes readAgain(const ImageView& image);
+};
+
+} // ZXing
@@ -17,6 +17,8 @@
 
 namespace ZXing {
 
+class Executor;
+
 /**
  * @brief Specify which algorithm to use for the grayscale to binary transformation.
  *
@@ -40,6 +42,15 @@ enum class EanAddOnSymbol : unsigned char // see above
 	Require, ///< Require EAN-2/EAN-5 Add-On symbol to be present
 };
 
+/**
+ * @brief Specify in which order the linear (1D) readers scan the rows of an image if tryHarder is enabled.
+ */
+enum class RowScan : unsigned char // see above
+{
+	MiddleOut, ///< every n-th row (n = height / 256) from the middle outwards
+	Adaptive,  ///< every 8th of those rows first, then bisect only the gaps next to rows with enough bars to be a symbol
+};
+
 /**
  * @brief Specify how the decoded byte content of a barcode should be transcoded to text.
  *
@@ -71,7 +82,7 @@ enum class TextMode : unsigned char // see above
  * The default settings are optimized for detection rate and can be tuned
  * for speed or specific use-cases.
  *
- * @see BarcodeFormats, Binarizer, TextMode, CharacterSet, ReadBarcodes
+ * @see BarcodeFormats, Binarizer, RowScan, TextMode, CharacterSet, ReadBarcodes
  */
 class ReaderOptions
 {
@@ -136,9 +147,28 @@ public:
 	/// The number of scan lines in a linear barcode that have to be equal to accept the result (default: 2).
 	ZX_PROPERTY(uint8_t, minLineCount, setMinLineCount)
 
+	/// The order in which the linear readers scan the rows with tryHarder enabled (default: RowScan::MiddleOut).
+	ZX_PROPERTY(RowScan, rowScan, setRowScan)
+
+	/// Keep the rows of stacked DataBar Expanded symbols that could not be decoded yet for the following read() calls of
+	/// a ReaderContext or BarcodeTracker, e.g. to assemble a symbol that is only partially visible in each video frame
+	/// or region of interest. The rows of a symbol that got no new ones in the last 8 frames (read() calls) are
+	/// dropped (default: false).
+	ZX_PROPERTY(bool, accumulateStackedRows, setAccumulateStackedRows)
+
 	/// The maximum number of symbols (barcodes) to detect / look for with ReadBarcodes().
 	ZX_PROPERTY(uint8_t, maxNumberOfSymbols, setMaxNumberOfSymbols)
 
+	/// The maximum number of threads ReadBarcodes() may use to binarize large images, to scan the downscaled and
+	/// inverted image variants and to sample and decode the QR code candidates concurrently, 0 means one per hardware
+	/// thread (default: 1).
+	ZX_PROPERTY(uint8_t, maxThreads, setMaxThreads)
+
+	/// The Executor (e.g. a ThreadPool) that provides the additional threads if maxThreads() is not 1. It is not
+	/// owned by the options and has to outlive the ReadBarcodes() calls. nullptr means a library internal pool
+	/// with one thread per hardware thread is used (default: nullptr).
+	ZX_PROPERTY(Executor*, executor, setExecutor)
+
 	/// Validate optional checksums where applicable (e.g. Code39, ITF) (default: false).
 	ZX_PROPERTY(bool, validateOptionalChecksum, setValidateOptionalChecksum)
 
@@ -204,6 +234,9 @@ public:
 
 	/// Check if any format is explicitly or implicitly enabled in the formats set
 	bool hasAnyFormat(const BarcodeFormats& formats) const noexcept;
+
+	/// Check if maxThreads() was set explicitly, i.e. 1 is not just the default
+	bool hasMaxThreads() const noexcept;
 #endif
 };
 
@@ -0,0 +1,150 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ThreadPool.h"
+#include "ParallelFor.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ZXing {
+
+struct ThreadPool::Data
+{
+	std::mutex mutex;
+	std::condition_variable cv;
+	std::deque<std::function<void()>> tasks;
+	std::vector<std::thread> threads;
+	bool stop = false;
+
+	void run()
+	{
+		while (true) {
+			std::function<void()> task;
+			{
+				std::unique_lock lock(mutex);
+				cv.wait(lock, [this] { return stop || !tasks.empty(); });
+				if (tasks.empty())
+					return;
+				task = std::move(tasks.front());
+				tasks.pop_front();
+			}
+			task();
+		}
+	}
+};
+
+ThreadPool::ThreadPool(int numThreads) : d(std::make_unique<Data>())
+{
+	numThreads = ResolveMaxThreads(numThreads);
+	for (int i = 0; i < numThreads; ++i)
+		d->threads.emplace_back([this] { d->run(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::scoped_lock lock(d->mutex);
+		d->stop = true;
+	}
+	d->cv.notify_all();
+	for (auto& t : d->threads)
+		t.join();
+}
+
+int ThreadPool::concurrency() const
+{
+	return static_cast<int>(d->threads.size());
+}
+
+void ThreadPool::post(std::function<void()> task)
+{
+	{
+		std::scoped_lock lock(d->mutex);
+		d->tasks.push_back(std::move(task));
+	}
+	d->cv.notify_one();
+}
+
+Executor& DefaultExecutor()
+{
+	// intentionally leaked: joining threads during static destruction can deadlock (e.g. on DLL unload)
+	static auto* pool = new ThreadPool();
+	return *pool;
+}
+
+int ResolveMaxThreads(int maxThreads)
+{
+	return maxThreads > 0 ? maxThreads : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+void ParallelFor(Executor* executor, int maxThreads, int n, const std::function<void(int)>& func)
+{
+	if (!executor && maxThreads != 1 && n > 1)
+		executor = &DefaultExecutor();
+
+	int helpers = executor ? std::min({n, ResolveMaxThreads(maxThreads), executor->concurrency() + 1}) - 1 : 0;
+
+	if (helpers <= 0) {
+		for (int i = 0; i < n; ++i)
+			func(i);
+		return;
+	}
+
+	// Shared with the posted tasks, which may only get to run after this function returned. By then all indices are
+	// taken, so they exit without touching func.
+	struct State
+	{
+		std::mutex mutex;
+		std::condition_variable cv;
+		const std::function<void(int)>* func;
+		int n, next = 0, running = 0;
+		std::exception_ptr error;
+
+		void work()
+		{
+			std::unique_lock lock(mutex);
+			while (next < n) {
+				int i = next++;
+				++running;
+				lock.unlock();
+				try {
+					(*func)(i);
+				} catch (...) {
+					lock.lock();
+					if (!error)
+						error = std::current_exception();
+					lock.unlock();
+				}
+				lock.lock();
+				--running;
+			}
+			if (running == 0)
+				cv.notify_all();
+		}
+	};
+
+	auto state = std::make_shared<State>();
+	state->func = &func;
+	state->n = n;
+
+	for (int i = 0; i < helpers; ++i)
+		executor->post([state] { state->work(); });
+
+	state->work();
+
+	std::unique_lock lock(state->mutex);
+	state->cv.wait(lock, [&] { return state->running == 0; });
+
+	if (state->error)
+		std::rethrow_exception(state->error);
+}
+
+} // ZXing
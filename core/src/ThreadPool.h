@@ -0,0 +1,55 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+namespace ZXing {
+
+/**
+ * @brief Interface of a task scheduler that ReadBarcodes() can use for its concurrent work.
+ *
+ * Implement it to run the library's tasks on a thread pool that is shared with the rest of the application, or
+ * use the ThreadPool class. See ReaderOptions::executor() and ReaderOptions::maxThreads().
+ *
+ * The library never blocks waiting for a posted task to start: the thread that posts tasks always works on the
+ * same job itself. It is therefore safe to call ReadBarcodes() from within a task running on the same executor.
+ */
+class Executor
+{
+public:
+	virtual ~Executor() = default;
+
+	/// Number of tasks that can run concurrently, used to limit how many tasks get posted for a single job.
+	virtual int concurrency() const = 0;
+
+	/// Schedule a task for asynchronous execution. Must be thread-safe.
+	virtual void post(std::function<void()> task) = 0;
+};
+
+/**
+ * @brief Simple fixed-size pool of worker threads processing posted tasks in FIFO order.
+ */
+class ThreadPool : public Executor
+{
+	struct Data;
+	std::unique_ptr<Data> d;
+
+public:
+	/// Start numThreads worker threads, 0 means one per hardware thread.
+	explicit ThreadPool(int numThreads = 0);
+	/// Finish all posted tasks, then join the worker threads.
+	~ThreadPool() override;
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	int concurrency() const override;
+	void post(std::function<void()> task) override;
+};
+
+} // ZXing
@@ -51,7 +51,7 @@ public:
 
 	std::shared_ptr<const BitMatrix> getBlackMatrix() const override
 	{
-		return std::make_shared<const BitMatrix>(binarize(_threshold));
+		return binarize(_threshold);
 	}
 };
 
@@ -0,0 +1,34 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+// Support for hand written SIMD kernels. On x86, each kernel is compiled for its instruction set extension with
+// ZX_TARGET("avx2") etc. and selected at runtime with ZX_CPU_SUPPORTS("avx2"), so the library itself does not
+// require any compiler flags beyond the baseline. MSVC has no equivalent of the target attribute, there all
+// extensions beyond SSE2 are only available when compiling with /arch:AVX2. NEON is part of the AArch64 baseline.
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define ZX_SIMD_X86
+#define ZX_TARGET(T) __attribute__((target(T)))
+#define ZX_CPU_SUPPORTS(F) (__builtin_cpu_init(), __builtin_cpu_supports(F))
+#elif defined(_M_X64)
+#include <string_view>
+#define ZX_SIMD_X86
+#define ZX_TARGET(T)
+#ifdef __AVX2__
+#define ZX_CPU_SUPPORTS(F) true
+#else
+#define ZX_CPU_SUPPORTS(F) (std::string_view(F) == "sse2")
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define ZX_SIMD_NEON
+#endif
+
+#if defined(ZX_SIMD_X86)
+#include <immintrin.h>
+#elif defined(ZX_SIMD_NEON)
+#include <arm_neon.h>
+#endif
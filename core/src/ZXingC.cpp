@@ -7,16 +7,21 @@
 #include "ZXingC.h"
 
 #include "ZXingCpp.h"
+#include "ParallelFor.h"
 #include "ZXAlgorithms.h"
 #include "ZXConfig.h"
 #include "Version.h"
 
+#include <algorithm>
 #include <bit>
+#include <chrono>
 #include <cstdlib>
 #include <exception>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 using namespace ZXing;
 
@@ -301,6 +306,7 @@ ZX_PROPERTY(bool, validateOptionalChecksum, ValidateOptionalChecksum)
 ZX_PROPERTY(bool, returnErrors, ReturnErrors)
 ZX_PROPERTY(int, minLineCount, MinLineCount)
 ZX_PROPERTY(int, maxNumberOfSymbols, MaxNumberOfSymbols)
+ZX_PROPERTY(int, maxThreads, MaxThreads)
 
 #undef ZX_PROPERTY
 
@@ -326,6 +332,7 @@ ZXing_BarcodeFormat* ZXing_ReaderOptions_getFormats(const ZXing_ReaderOptions* o
 
 ZX_ENUM_PROPERTY(Binarizer, binarizer, Binarizer)
 ZX_ENUM_PROPERTY(EanAddOnSymbol, eanAddOnSymbol, EanAddOnSymbol)
+ZX_ENUM_PROPERTY(RowScan, rowScan, RowScan)
 ZX_ENUM_PROPERTY(TextMode, textMode, TextMode)
 
 #undef ZX_ENUM_PROPERTY
@@ -344,6 +351,55 @@ ZXing_Barcodes* ZXing_ReadBarcodes(const ZXing_ImageView* iv, const ZXing_Reader
 	ZX_CATCH(NULL);
 }
 
+ZXing_CancellationToken* ZXing_CancellationToken_new()
+{
+	ZX_TRY(new CancellationToken());
+}
+
+void ZXing_CancellationToken_delete(ZXing_CancellationToken* token)
+{
+	delete token;
+}
+
+void ZXing_CancellationToken_cancel(ZXing_CancellationToken* token)
+{
+	if (token)
+		token->cancel();
+}
+
+ZXing_Barcodes** ZXing_ReadBarcodesBatch(const ZXing_ImageView* const* ivs, int count, const ZXing_ReaderOptions* opts,
+										 const ZXing_CancellationToken* cancel, int timeoutMs, ZXing_BatchStatus* statuses)
+{
+	ZX_CHECK(ivs || count == 0, "ImageView array param is NULL")
+	ZX_CHECK(count >= 0, "count param is negative")
+	try {
+		std::vector<ImageView> images;
+		for (int i = 0; i < count; ++i) {
+			ZX_CHECK(ivs[i], "ImageView param is NULL")
+			images.push_back(*ivs[i]);
+		}
+
+		auto res = ReadBarcodesBatch(images, opts ? *opts : ReaderOptions{}, DefaultExecutor(), cancel,
+									 std::chrono::milliseconds(timeoutMs));
+
+		// own the results until all of them are allocated, so a throwing new does not leak the earlier ones
+		std::vector<std::unique_ptr<Barcodes>> barcodes(count);
+		for (int i = 0; i < count; ++i)
+			if (!res[i].barcodes.empty())
+				barcodes[i] = std::make_unique<Barcodes>(std::move(res[i].barcodes));
+
+		auto ret = (ZXing_Barcodes**)calloc(std::max(count, 1), sizeof(ZXing_Barcodes*));
+		ZX_CHECK(ret, "Out of memory")
+		for (int i = 0; i < count; ++i) {
+			ret[i] = barcodes[i] ? barcodes[i].release() : &emptyBarcodes;
+			if (statuses)
+				statuses[i] = static_cast<ZXing_BatchStatus>(res[i].status);
+		}
+		return ret;
+	}
+	ZX_CATCH(NULL);
+}
+
 
 /*
  * MARK: - CreateBarcode.h
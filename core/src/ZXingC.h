@@ -19,6 +19,7 @@ typedef ZXing::Barcodes ZXing_Barcodes;
 typedef ZXing::ImageView ZXing_ImageView;
 typedef ZXing::Image ZXing_Image;
 typedef ZXing::ReaderOptions ZXing_ReaderOptions;
+typedef ZXing::CancellationToken ZXing_CancellationToken;
 typedef ZXing::CreatorOptions ZXing_CreatorOptions;
 typedef ZXing::WriterOptions ZXing_WriterOptions;
 
@@ -31,6 +32,7 @@ typedef struct ZXing_Barcodes ZXing_Barcodes;
 typedef struct ZXing_ImageView ZXing_ImageView;
 typedef struct ZXing_Image ZXing_Image;
 typedef struct ZXing_ReaderOptions ZXing_ReaderOptions;
+typedef struct ZXing_CancellationToken ZXing_CancellationToken;
 typedef struct ZXing_CreatorOptions ZXing_CreatorOptions;
 typedef struct ZXing_WriterOptions ZXing_WriterOptions;
 
@@ -61,6 +63,12 @@ typedef enum {
 	ZXing_ImageFormat_ARGB = 0x04010203,
 	ZXing_ImageFormat_BGRA = 0x04020100,
 	ZXing_ImageFormat_ABGR = 0x04030201,
+	ZXing_ImageFormat_NV12 = 0x01000000,
+	ZXing_ImageFormat_NV21 = 0x01000000,
+	ZXing_ImageFormat_I420 = 0x01000000,
+	ZXing_ImageFormat_YV12 = 0x01000000,
+	ZXing_ImageFormat_YUYV = 0x02000000,
+	ZXing_ImageFormat_UYVY = 0x02010101,
 } ZXing_ImageFormat;
 
 ZXing_ImageView* ZXing_ImageView_new(const uint8_t* data, int width, int height, ZXing_ImageFormat format, int rowStride,
@@ -183,6 +191,12 @@ typedef enum
 	ZXing_EanAddOnSymbol_Require,
 } ZXing_EanAddOnSymbol;
 
+typedef enum
+{
+	ZXing_RowScan_MiddleOut,
+	ZXing_RowScan_Adaptive,
+} ZXing_RowScan;
+
 typedef enum
 {
 	ZXing_TextMode_Plain,
@@ -209,9 +223,11 @@ void ZXing_ReaderOptions_setReturnErrors(ZXing_ReaderOptions* opts, bool returnE
 void ZXing_ReaderOptions_setFormats(ZXing_ReaderOptions* opts, const ZXing_BarcodeFormat* formats, int count);
 void ZXing_ReaderOptions_setBinarizer(ZXing_ReaderOptions* opts, ZXing_Binarizer binarizer);
 void ZXing_ReaderOptions_setEanAddOnSymbol(ZXing_ReaderOptions* opts, ZXing_EanAddOnSymbol eanAddOnSymbol);
+void ZXing_ReaderOptions_setRowScan(ZXing_ReaderOptions* opts, ZXing_RowScan rowScan);
 void ZXing_ReaderOptions_setTextMode(ZXing_ReaderOptions* opts, ZXing_TextMode textMode);
 void ZXing_ReaderOptions_setMinLineCount(ZXing_ReaderOptions* opts, int n);
 void ZXing_ReaderOptions_setMaxNumberOfSymbols(ZXing_ReaderOptions* opts, int n);
+void ZXing_ReaderOptions_setMaxThreads(ZXing_ReaderOptions* opts, int n);
 
 bool ZXing_ReaderOptions_getTryHarder(const ZXing_ReaderOptions* opts);
 bool ZXing_ReaderOptions_getTryRotate(const ZXing_ReaderOptions* opts);
@@ -226,9 +242,11 @@ bool ZXing_ReaderOptions_getReturnErrors(const ZXing_ReaderOptions* opts);
 ZXing_BarcodeFormat* ZXing_ReaderOptions_getFormats(const ZXing_ReaderOptions* opts, int* outCount);
 ZXing_Binarizer ZXing_ReaderOptions_getBinarizer(const ZXing_ReaderOptions* opts);
 ZXing_EanAddOnSymbol ZXing_ReaderOptions_getEanAddOnSymbol(const ZXing_ReaderOptions* opts);
+ZXing_RowScan ZXing_ReaderOptions_getRowScan(const ZXing_ReaderOptions* opts);
 ZXing_TextMode ZXing_ReaderOptions_getTextMode(const ZXing_ReaderOptions* opts);
 int ZXing_ReaderOptions_getMinLineCount(const ZXing_ReaderOptions* opts);
 int ZXing_ReaderOptions_getMaxNumberOfSymbols(const ZXing_ReaderOptions* opts);
+int ZXing_ReaderOptions_getMaxThreads(const ZXing_ReaderOptions* opts);
 
 /*
  * MARK: - ReadBarcode.h
@@ -241,6 +259,30 @@ int ZXing_ReaderOptions_getMaxNumberOfSymbols(const ZXing_ReaderOptions* opts);
  */
 ZXing_Barcodes* ZXing_ReadBarcodes(const ZXing_ImageView* iv, const ZXing_ReaderOptions* opts);
 
+typedef enum
+{
+	ZXing_BatchStatus_Complete,
+	ZXing_BatchStatus_TimedOut,
+	ZXing_BatchStatus_Cancelled,
+} ZXing_BatchStatus;
+
+ZXing_CancellationToken* ZXing_CancellationToken_new();
+void ZXing_CancellationToken_delete(ZXing_CancellationToken* token);
+/** Thread-safe, stops the ZXing_ReadBarcodesBatch() calls that were passed the token. */
+void ZXing_CancellationToken_cancel(ZXing_CancellationToken* token);
+
+/**
+ * Read barcodes from count images concurrently, see ZXing::ReadBarcodesBatch(). The additional threads come from a
+ * library internal pool with one thread per hardware thread, ZXing_ReaderOptions_setMaxThreads() can limit their number
+ * (1 reads the images one after the other on the calling thread).
+ * Note: opts, cancel and statuses are optional, i.e. they can be NULL. timeoutMs is the time budget of each image, 0 means
+ * none. If statuses is not NULL, it receives the ZXing_BatchStatus of each image.
+ * @return NULL in case of an error (e.g. an invalid image or out of memory), otherwise an array of count ZXing_Barcodes
+ * pointers in the order of the images. Each of them has to be freed with ZXing_Barcodes_delete(), the array with ZXing_free().
+ */
+ZXing_Barcodes** ZXing_ReadBarcodesBatch(const ZXing_ImageView* const* ivs, int count, const ZXing_ReaderOptions* opts,
+										 const ZXing_CancellationToken* cancel, int timeoutMs, ZXing_BatchStatus* statuses);
+
 
 /*
  * MARK: - CreateBarcode.h
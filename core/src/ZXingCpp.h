@@ -6,8 +6,11 @@
 #pragma once
 
 #include "BarcodeFormat.h"
+#include "BarcodeTracker.h"
 #include "CreateBarcode.h"
 #include "ReadBarcode.h"
+#include "ReaderContext.h"
+#include "ThreadPool.h"
 #include "WriteBarcode.h"
 #include "Version.h"
 
@@ -28,6 +28,9 @@ static constexpr int CHARACTER_ENCODINGS[] = {
 
 static_assert(Size(ALPHABET) == Size(CHARACTER_ENCODINGS), "table size mismatch");
 
+// direct-index table from the 7 bit narrow/wide pattern to the character
+static constexpr auto CHARACTER_TABLE = RowReader::BitPatternTable<7>(CHARACTER_ENCODINGS, ALPHABET);
+
 // some industries use a checksum standard but this is not part of the original codabar standard
 // for more information see : http://www.mecsw.com/specs/codabar.html
 
@@ -62,7 +65,8 @@ BarcodeData CodabarReader::decodePattern(int rowNumber, PatternView& next, std::
 	const int minCharCount = 4;
 	auto isStartOrStopSymbol = [](char c) { return 'A' <= c && c <= 'D'; };
 
-	next = FindLeftGuard<CHAR_LEN>(next, minCharCount * CHAR_LEN, IsLeftGuard);
+	// IsLeftGuard requires spaceInPixel > QUIET_ZONE_SCALE * view.sum() >= QUIET_ZONE_SCALE * view.sum(3)
+	next = FindLeftGuard<CHAR_LEN>(next, minCharCount * CHAR_LEN, IsLeftGuard, QUIET_ZONE_SCALE);
 	if (!next.isValid())
 		return {};
 
@@ -71,7 +75,7 @@ BarcodeData CodabarReader::decodePattern(int rowNumber, PatternView& next, std::
 
 	std::string txt;
 	txt.reserve(20);
-	txt += DecodeNarrowWidePattern(next, CHARACTER_ENCODINGS, ALPHABET); // read off the start pattern
+	txt += DecodeNarrowWidePattern(next, CHARACTER_TABLE); // read off the start pattern
 
 	if (!isStartOrStopSymbol(txt.back()))
 		return {};
@@ -81,7 +85,7 @@ BarcodeData CodabarReader::decodePattern(int rowNumber, PatternView& next, std::
 		if (!next.skipSymbol() || !next.skipSingle(maxInterCharacterSpace))
 			return {};
 
-		txt += DecodeNarrowWidePattern(next, CHARACTER_ENCODINGS, ALPHABET);
+		txt += DecodeNarrowWidePattern(next, CHARACTER_TABLE);
 		if (txt.back() == 0)
 			return {};
 	} while (!isStartOrStopSymbol(txt.back()));
@@ -124,7 +124,7 @@ constexpr std::array<FixedPattern<CHAR_LEN, CHAR_MODS>, 107> CODE_PATTERNS = { {
 	{ 2, 3, 3, 1, 1, 1 }  // STOP_CODE followed by 2-wide termination bar
 } };
 
-// See ISO/IEC 15417:2007(E) Table 2
-constexpr auto E2E_PATTERNS = PatternsToE2EInts(CODE_PATTERNS);
+// See ISO/IEC 15417:2007(E) Table 2, the direct-index table from the E2EKey of each pattern to its code
+constexpr auto E2E_INDEX = PatternsToE2EIndex(CODE_PATTERNS);
 
 } // namespace ZXing::OneD::Code128
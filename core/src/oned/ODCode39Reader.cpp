@@ -35,6 +35,9 @@ static constexpr std::array CHARACTER_ENCODINGS = {
 
 static_assert(Size(ALPHABET) == Size(CHARACTER_ENCODINGS), "table size mismatch");
 
+// direct-index table from the 9 bit narrow/wide pattern to the character
+static constexpr auto CHARACTER_TABLE = RowReader::BitPatternTable<9>(CHARACTER_ENCODINGS, ALPHABET);
+
 static constexpr std::array<char, 26> PERCENTAGE_MAPPING = {
 	'A' - 38, 'B' - 38, 'C' - 38, 'D' - 38, 'E' - 38,	// %A to %E map to control codes ESC to USep
 	'F' - 11, 'G' - 11, 'H' - 11, 'I' - 11, 'J' - 11,	// %F to %J map to ; < = > ?
@@ -133,7 +136,7 @@ BarcodeData Code39Reader::decodePattern(int rowNumber, PatternView& next, std::u
 	if (!next.isValid())
 		return {};
 
-	if (!isStartOrStopSymbol(DecodeNarrowWidePattern(next, CHARACTER_ENCODINGS, ALPHABET))) // read off the start pattern
+	if (!isStartOrStopSymbol(DecodeNarrowWidePattern(next, CHARACTER_TABLE))) // read off the start pattern
 		return {};
 
 	int xStart = next.pixelsInFront();
@@ -147,7 +150,7 @@ BarcodeData Code39Reader::decodePattern(int rowNumber, PatternView& next, std::u
 		if (!next.skipSymbol() || !next.skipSingle(maxInterCharacterSpace))
 			return {};
 
-		txt += DecodeNarrowWidePattern(next, CHARACTER_ENCODINGS, ALPHABET);
+		txt += DecodeNarrowWidePattern(next, CHARACTER_TABLE);
 		if (txt.back() == 0)
 			return {};
 	} while (!isStartOrStopSymbol(txt.back()));
@@ -66,7 +66,8 @@ constexpr std::array<FixedPattern<CHAR_LEN, CHAR_MODS>, 48> CODE_PATTERNS = { {
 	{ 1, 1, 1, 1, 4, 1 }  // STOP_CODE / Asterisk
 } };
 
-constexpr auto E2E_PATTERNS = PatternsToE2EInts(CODE_PATTERNS);
+// direct-index table from the E2EKey of each pattern to its index in CODE_PATTERNS
+constexpr auto E2E_INDEX = PatternsToE2EIndex(CODE_PATTERNS);
 
 
 // Note that 'abcd' are dummy characters in place of control characters.
@@ -75,6 +76,6 @@ constexpr char ALPHABET[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ-. $/+%abcd*";
 
 static_assert(Size(ALPHABET) == Size(CODE_PATTERNS), "table size mismatch");
 
-constexpr int ASTERISK_ENCODING = E2E_PATTERNS[47];
+constexpr int ASTERISK_INDEX = 47;
 
 } // namespace ZXing::OneD::Code93
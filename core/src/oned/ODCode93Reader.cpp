@@ -54,7 +54,7 @@ static bool IsStartGuard(const PatternView& window, int spaceInPixel)
 	// pattern size that is missed otherwise. We check for the remaining 2 slots for plausibility of the 4:1 ratio.
 	return IsPattern(window, FixedPattern<4, 4>{1, 1, 1, 1}, spaceInPixel, QUIET_ZONE_SCALE * 12) &&
 		   window[4] > 3 * window[5] - 2 &&
-		   ToInt(NormalizedE2EPattern<CHAR_LEN, CHAR_MODS>(window)) == ASTERISK_ENCODING;
+		   LookupE2EPattern<CHAR_LEN, CHAR_MODS>(window, E2E_INDEX) == ASTERISK_INDEX;
 }
 
 BarcodeData Code93Reader::decodePattern(int rowNumber, PatternView& next, std::unique_ptr<DecodingState>&) const
@@ -62,7 +62,8 @@ BarcodeData Code93Reader::decodePattern(int rowNumber, PatternView& next, std::u
 	// minimal number of characters that must be present (including start, stop, checksum and 1 payload characters)
 	int minCharCount = 5;
 
-	next = FindLeftGuard<CHAR_LEN>(next, minCharCount * CHAR_LEN, IsStartGuard);
+	// IsStartGuard requires spaceInPixel + 1 >= QUIET_ZONE_SCALE * 12 * view.sum(4) / 4
+	next = FindLeftGuard<CHAR_LEN>(next, minCharCount * CHAR_LEN, IsStartGuard, QUIET_ZONE_SCALE * 12 / 4);
 	if (!next.isValid())
 		return {};
 
@@ -76,7 +77,8 @@ BarcodeData Code93Reader::decodePattern(int rowNumber, PatternView& next, std::u
 		if (!next.skipSymbol())
 			return {};
 
-		txt += LookupBitPattern(ToInt(NormalizedE2EPattern<CHAR_LEN, CHAR_MODS>(next)), E2E_PATTERNS, ALPHABET);
+		int i = LookupE2EPattern<CHAR_LEN, CHAR_MODS>(next, E2E_INDEX);
+		txt += i == -1 ? '\0' : ALPHABET[i];
 
 		if (txt.back() == 0)
 			return {};
@@ -21,6 +21,9 @@ public:
 	using RowReader::RowReader;
 
 	BarcodeData decodePattern(int rowNumber, PatternView& next, std::unique_ptr<DecodingState>&) const override;
+	bool usesDecodingState() const override { return true; }
+	// the data track has few and wide elements
+	int minRowSize() const override { return 10; }
 };
 
 } // namespace ZXing::OneD
@@ -8,14 +8,18 @@
 #include "ODDataBarExpandedReader.h"
 
 #include "BarcodeFormat.h"
+#include "BinaryBitmap.h"
 #include "DecoderResult.h"
 #include "DetectorResult.h"
 #include "ODDataBarCommon.h"
 #include "ODDataBarExpandedBitDecoder.h"
 #include "BarcodeData.h"
+#include "ReaderOptions.h"
 
+#include <algorithm>
 #include <cmath>
 #include <map>
+#include <mutex>
 #include <vector>
 
 namespace ZXing::OneD {
@@ -234,7 +238,12 @@ static Pairs ReadRowOfPairs(PatternView& next, int rowNumber)
 
 using PairMap = std::map<int, Pairs>;
 
-// inserts all pairs inside row into the PairMap or increases their count respectively.
+// only the N most common pairs per finder are tried in FindValidSequence, this means the absolute maximum number of
+// ChecksumIsValid() evaluations is N^11 (11 is the maximum sequence length).
+constexpr int N = 2;
+
+// inserts all pairs inside row into the PairMap or increases their count respectively. Returns whether this changed
+// the set of pairs FindValidSequence() looks at, i.e. whether a failed search could succeed now.
 static bool Insert(PairMap& all, Pairs&& row)
 {
 	bool res = false;
@@ -242,14 +251,18 @@ static bool Insert(PairMap& all, Pairs&& row)
 		auto& pairs = all[pair.finder];
 		if (auto i = Find(pairs, pair); i != pairs.end()) {
 			i->count++;
+			bool wasTried = i - pairs.begin() < N;
 			// bubble sort the pairs with the highest view count to the front so we test them first in FindValidSequence
 			while (i != pairs.begin() && i[0].count > i[-1].count) {
 				std::swap(i[-1], i[0]);
 				--i;
 			}
-		} else
+			res |= !wasTried && i - pairs.begin() < N;
+		} else {
 			pairs.push_back(pair);
-		res = true;
+			// all FINDER_A pairs are tried as the first one of the sequence
+			res |= pair.finder == FINDER_A || Size(pairs) <= N;
+		}
 	}
 	return res;
 }
@@ -261,9 +274,6 @@ static bool FindValidSequence(const PairMap& all, ITER begin, ITER end, Pairs& s
 		return ChecksumIsValid(stack);
 
 	if (auto ppairs = all.find(*begin); ppairs != all.end()) {
-		// only try the N most common pairs, this means the absolute maximum number of ChecksumIsValid() evaluations
-		// is N^11 (11 is the maximum sequence length).
-		constexpr int N = 2;
 		// TODO c++20 ranges::views::take()
 		auto& pairs = ppairs->second;
 		int n = 0;
@@ -323,11 +333,126 @@ static BitArray BuildBitArray(const Pairs& pairs)
 	return res;
 }
 
+// the module size of a row of pairs, used to tell the pairs of different symbols apart
+static float ModuleSize(const Pairs& row)
+{
+	int pixels = 0, modules = 0;
+	for (const Pair& p : row) {
+		pixels += p.xStop - p.xStart;
+		modules += p.right ? 17 + 15 + 17 : 17 + 15;
+	}
+	return float(pixels) / modules;
+}
+
+// the rotation and inversion of the image a scan runs over, the rows of different ones never belong to the same symbol
+struct ScanVariant
+{
+	bool rotated = false, inverted = false;
+	bool operator==(const ScanVariant&) const = default;
+};
+
+// the pairs seen so far of one symbol, or of several ones with (almost) the same module size
+struct Assembly
+{
+	ScanVariant variant;
+	float moduleSize;
+	PairMap pairs;
+	int lastFrame;          // the last frame this assembly got new pairs in
+	bool exhausted = false; // FindValidSequence failed and Insert did not change anything relevant since
+};
+
+// the assemblies of all symbols seen in one scan or, with accumulateStackedRows(), in a number of recent frames
+struct Assemblies
+{
+	// the module sizes of the rows of one symbol differ by a few percent at most, even with some perspective
+	// distortion, but e.g. the downscaled image variant is far off.
+	static constexpr float MAX_MODULE_SIZE_RATIO = 1.25f;
+	// an assembly that has not seen any new pairs for this many frames (read() calls) is considered to be out of view
+	static constexpr int MAX_IDLE_FRAMES = 8;
+	// the pairs per finder that are kept across frames, the less common ones are mostly misreads
+	static constexpr int MAX_KEPT_PAIRS = 8;
+
+	std::vector<Assembly> list;
+	int frame = 0;
+
+	Assembly& find(ScanVariant variant, float moduleSize)
+	{
+		auto matches = [&](const Assembly& a) {
+			return a.variant == variant &&
+				   std::max(a.moduleSize, moduleSize) <= MAX_MODULE_SIZE_RATIO * std::min(a.moduleSize, moduleSize);
+		};
+		auto i = std::ranges::find_if(list, matches);
+		if (i == list.end())
+			i = list.insert(list.end(), {variant, moduleSize, {}, frame});
+		// follow the symbol as it moves closer to or away from the camera
+		i->moduleSize = moduleSize;
+		i->lastFrame = frame;
+		return *i;
+	}
+
+	void newFrame()
+	{
+		++frame;
+		std::erase_if(list, [&](const Assembly& a) { return frame - a.lastFrame > MAX_IDLE_FRAMES; });
+		for (auto& a : list)
+			for (auto& [finder, pairs] : a.pairs)
+				if (Size(pairs) > MAX_KEPT_PAIRS) {
+					pairs.resize(MAX_KEPT_PAIRS);
+					a.exhausted = false;
+				}
+	}
+};
+
+/**
+* The Assemblies shared by all scans of a reader with accumulateStackedRows(). A stacked symbol that is split across
+* video frames, tiles or regions of interest is thereby assembled from the rows seen in each of them, and a symbol
+* that is seen again needs no search from scratch. The pairs are only matched by their scan variant, module size and
+* finder sequence, not by their position in the image, which changes from one frame or tile to the next.
+*
+* The scans of a frame may run concurrently (e.g. the downscaled image variants or the regions of interest), so the
+* mutex is held while a row is added, not for a whole scan.
+*/
+struct DataBarExpandedReader::Cache
+{
+	std::mutex mutex;
+	Assemblies assemblies;
+};
+
 struct DBERState : public RowReader::DecodingState
 {
-	PairMap allPairs;
+	ScanVariant variant;
+	Assemblies own;
+	Assemblies* assemblies = &own;
+	std::mutex* mutex = nullptr;
+
+	DBERState(DataBarExpandedReader::Cache* cache, ScanVariant variant) : variant(variant)
+	{
+		if (cache) {
+			assemblies = &cache->assemblies;
+			mutex = &cache->mutex;
+		}
+	}
 };
 
+DataBarExpandedReader::DataBarExpandedReader(const ReaderOptions& opts)
+	: RowReader(opts), _cache(opts.accumulateStackedRows() ? std::make_unique<Cache>() : nullptr)
+{}
+
+DataBarExpandedReader::~DataBarExpandedReader() = default;
+
+std::unique_ptr<RowReader::DecodingState> DataBarExpandedReader::newDecodingState(const BinaryBitmap& image, bool rotate) const
+{
+	return std::make_unique<DBERState>(_cache.get(), ScanVariant{rotate, image.inverted()});
+}
+
+void DataBarExpandedReader::newFrame()
+{
+	if (_cache) {
+		std::scoped_lock lock(_cache->mutex);
+		_cache->assemblies.newFrame();
+	}
+}
+
 BarcodeData DataBarExpandedReader::decodePattern(int rowNumber, PatternView& view, std::unique_ptr<RowReader::DecodingState>& state) const
 {
 #if 0 // non-stacked version
@@ -337,8 +462,8 @@ BarcodeData DataBarExpandedReader::decodePattern(int rowNumber, PatternView& vie
 		return {};
 #else
 	if (!state)
-		state = std::make_unique<DBERState>();
-	auto& allPairs = static_cast<DBERState*>(state.get())->allPairs;
+		state = std::make_unique<DBERState>(_cache.get(), ScanVariant{});
+	auto& dbState = *static_cast<DBERState*>(state.get());
 
 	// Stacked codes can be laid out in a number of ways. The following rules apply:
 	//  * the first row starts with FINDER_A in left-to-right (l2r) layout
@@ -353,10 +478,17 @@ BarcodeData DataBarExpandedReader::decodePattern(int rowNumber, PatternView& vie
 	//    r l r l    |    r l     |     r l r
 	//    L R L R    |    r       |     l
 
-	if (!Insert(allPairs, ReadRowOfPairs<true>(view, rowNumber)))
+	auto row = ReadRowOfPairs<true>(view, rowNumber);
+	if (row.empty())
+		return {};
+
+	auto lock = dbState.mutex ? std::unique_lock(*dbState.mutex) : std::unique_lock<std::mutex>();
+	auto& assembly = dbState.assemblies->find(dbState.variant, ModuleSize(row));
+	if (!Insert(assembly.pairs, std::move(row)) && assembly.exhausted)
 		return {};
 
-	auto pairs = FindValidSequence(allPairs);
+	auto pairs = FindValidSequence(assembly.pairs);
+	assembly.exhausted = pairs.empty();
 	if (pairs.empty())
 		return {};
 #endif
@@ -365,7 +497,7 @@ BarcodeData DataBarExpandedReader::decodePattern(int rowNumber, PatternView& vie
 	if (txt.empty())
 		return {};
 
-	RemovePairs(allPairs, pairs);
+	RemovePairs(assembly.pairs, pairs);
 
 	bool isStacked =
 		std::any_of(pairs.begin() + 1, pairs.end(), [center = pairs.front().center()](const Pair& p) { return p.xStart < center; });
@@ -9,17 +9,34 @@
 
 #include "ODRowReader.h"
 
+#include <memory>
+
 namespace ZXing::OneD {
 
 /**
 * Decodes DataBarExpandedReader (formerly known as RSS) symbols, including truncated and stacked variants. See ISO/IEC 24724:2006.
+*
+* The pairs of a stacked symbol are collected over the rows of a scan, grouped by their module size, until they form a
+* valid sequence. With ReaderOptions::accumulateStackedRows() the pairs of not yet complete symbols are kept for the
+* following scans (of the next frame or tile), see Cache.
 */
 class DataBarExpandedReader : public RowReader
 {
 public:
-	using RowReader::RowReader;
+	struct Cache;
+
+	explicit DataBarExpandedReader(const ReaderOptions& opts);
+	~DataBarExpandedReader() override;
 
 	BarcodeData decodePattern(int rowNumber, PatternView& view, std::unique_ptr<DecodingState>& state) const override;
+	std::unique_ptr<DecodingState> newDecodingState(const BinaryBitmap& image, bool rotate) const override;
+	void newFrame() override;
+	bool usesDecodingState() const override { return true; }
+	// the finder patterns contain spaces of up to 9 modules, which the row classifier takes for a quiet zone
+	int minRowSize() const override { return 10; }
+
+private:
+	std::unique_ptr<Cache> _cache; // only used with accumulateStackedRows()
 };
 
 } // namespace ZXing::OneD
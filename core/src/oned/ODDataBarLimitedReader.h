@@ -18,6 +18,8 @@ public:
 	using RowReader::RowReader;
 
 	BarcodeData decodePattern(int rowNumber, PatternView& next, std::unique_ptr<DecodingState>& state) const override;
+	// the characters contain spaces of up to 8 modules, which the row classifier takes for a quiet zone
+	int minRowSize() const override { return 10; }
 };
 
 } // namespace ZXing::OneD
@@ -20,6 +20,9 @@ public:
 	using RowReader::RowReader;
 
 	BarcodeData decodePattern(int rowNumber, PatternView& next, std::unique_ptr<DecodingState>& state) const override;
+	bool usesDecodingState() const override { return true; }
+	// the finder patterns contain spaces of up to 9 modules, which the row classifier takes for a quiet zone
+	int minRowSize() const override { return 10; }
 };
 
 } // namespace ZXing::OneD
@@ -16,7 +16,9 @@
 #include "JSON.h"
 #include "SymbologyIdentifier.h"
 
+#include <array>
 #include <cmath>
+#include <cstdint>
 
 namespace ZXing::OneD {
 
@@ -28,7 +30,22 @@ constexpr auto UPCE_END_PATTERN      = FixedPattern<6, 6>{1, 1, 1, 1, 1, 1};
 constexpr auto EXT_START_PATTERN     = FixedPattern<3, 4>{1, 1, 2};
 constexpr auto EXT_SEPARATOR_PATTERN = FixedPattern<2, 2>{1, 1};
 
-static const int FIRST_DIGIT_ENCODINGS[] = {0x00, 0x0B, 0x0D, 0x0E, 0x13, 0x19, 0x1C, 0x15, 0x16, 0x1A};
+static constexpr std::array FIRST_DIGIT_ENCODINGS = {0x00, 0x0B, 0x0D, 0x0E, 0x13, 0x19, 0x1C, 0x15, 0x16, 0x1A};
+
+// Bit p of ParityPrefixes[n] is set if p is the first n bits of one of the given 6 bit parity patterns. This allows
+// to reject a candidate as soon as the parity of one of its left hand digits can not lead to a valid pattern.
+template <size_t N>
+constexpr std::array<uint64_t, 7> ParityPrefixes(const std::array<int, N>& patterns)
+{
+	std::array<uint64_t, 7> res = {};
+	for (int p : patterns)
+		for (int n = 0; n <= 6; ++n)
+			res[n] |= uint64_t(1) << (p >> (6 - n));
+	return res;
+}
+
+static constexpr auto EAN13_PARITY_PREFIXES = ParityPrefixes(FIRST_DIGIT_ENCODINGS);
+static const auto UPCE_PARITY_PREFIXES = ParityPrefixes(UPCEANCommon::NUMSYS_AND_CHECK_DIGIT_PATTERNS);
 
 // The GS1 specification has the following to say about quiet zones
 // Type: EAN-13 | EAN-8 | UPC-A | UPC-E | EAN Add-on | UPC Add-on
@@ -43,15 +60,15 @@ constexpr float QUIET_ZONE_ADDON = 3;
 // There is a single sample (ean13-1/12.png) that fails to decode with these (new) settings because
 // it has a right-side quiet zone of only about 4.5 modules, which is clearly out of spec.
 
+// These two values are critical for determining how permissive the decoding will be.
+// We've arrived at these values through a lot of trial and error. Setting them any higher
+// lets false positives creep in quickly.
+constexpr float MAX_AVG_VARIANCE = 0.48f;
+constexpr float MAX_INDIVIDUAL_VARIANCE = 0.7f;
+
 static bool DecodeDigit(const PatternView& view, std::string& txt, int* lgPattern = nullptr)
 {
 #if 1
-	// These two values are critical for determining how permissive the decoding will be.
-	// We've arrived at these values through a lot of trial and error. Setting them any higher
-	// lets false positives creep in quickly.
-	static constexpr float MAX_AVG_VARIANCE = 0.48f;
-	static constexpr float MAX_INDIVIDUAL_VARIANCE = 0.7f;
-
 	int bestMatch =
 		lgPattern ? RowReader::DecodeDigit(view, UPCEANCommon::L_AND_G_PATTERNS, MAX_AVG_VARIANCE, MAX_INDIVIDUAL_VARIANCE, false)
 				  : RowReader::DecodeDigit(view, UPCEANCommon::L_PATTERNS, MAX_AVG_VARIANCE, MAX_INDIVIDUAL_VARIANCE, false);
@@ -113,6 +130,60 @@ static bool DecodeDigits(int digitCount, PatternView& next, std::string& txt, in
 	return true;
 }
 
+/**
+ * The up to 6 left hand digits following the start guard at begin. EAN-13, EAN-8 and UPC-E all start with them, so
+ * each digit is matched against the L (and G) patterns at most once per guard, no matter how many of the formats are
+ * tried. The results are the same as from DecodeDigit().
+ */
+class LeftDigits
+{
+	static constexpr int UNKNOWN = -2;
+	PatternView _begin;
+	// index of the best match in L_AND_G_PATTERNS and L_PATTERNS or -1 if there is none
+	std::array<int8_t, 6> _lg, _l;
+
+	int match(int i, bool withG)
+	{
+		auto view = _begin.subView(END_PATTERN.size() + i * CHAR_LEN, CHAR_LEN);
+		if (withG)
+			return RowReader::DecodeDigit(view, UPCEANCommon::L_AND_G_PATTERNS, MAX_AVG_VARIANCE, MAX_INDIVIDUAL_VARIANCE, false);
+		// the L_PATTERNS are the first half of the L_AND_G_PATTERNS, so the best L match is known unless that is a G
+		if (_lg[i] != UNKNOWN && _lg[i] < 10) // includes -1
+			return _lg[i];
+		return RowReader::DecodeDigit(view, UPCEANCommon::L_PATTERNS, MAX_AVG_VARIANCE, MAX_INDIVIDUAL_VARIANCE, false);
+	}
+
+public:
+	explicit LeftDigits(PatternView begin) : _begin(begin)
+	{
+		_lg.fill(UNKNOWN);
+		_l.fill(UNKNOWN);
+	}
+
+	/**
+	 * Append the first digitCount digits to txt. If lgPattern is given, the G patterns are considered as well and
+	 * their parity bits are appended to lgPattern, which has to stay a prefix of one of the validPrefixes.
+	 */
+	bool decode(int digitCount, std::string& txt, int* lgPattern = nullptr, const std::array<uint64_t, 7>* validPrefixes = nullptr)
+	{
+		auto& matches = lgPattern ? _lg : _l;
+		for (int i = 0; i < digitCount; ++i) {
+			if (matches[i] == UNKNOWN)
+				matches[i] = narrow_cast<int8_t>(match(i, lgPattern != nullptr));
+			if (matches[i] == -1)
+				return false;
+
+			txt += ToDigit(matches[i] % 10);
+			if (lgPattern) {
+				AppendBit(*lgPattern, matches[i] >= 10);
+				if (validPrefixes && !((*validPrefixes)[i + 1] >> *lgPattern & 1))
+					return false;
+			}
+		}
+		return true;
+	}
+};
+
 struct PartialResult
 {
 	std::string txt;
@@ -129,20 +200,19 @@ bool _ret_false_debug_helper()
 }
 #define CHECK(A) if(!(A)) return _ret_false_debug_helper();
 
-static bool EAN13(PartialResult& res, PatternView begin)
+static bool EAN13(PartialResult& res, PatternView begin, LeftDigits& left)
 {
 	auto mid = begin.subView(27, MID_PATTERN.size());
 	auto end = begin.subView(56, END_PATTERN.size());
 
 	CHECK(IsRightGuard(end, END_PATTERN, QUIET_ZONE_RIGHT_EAN) && IsPattern(mid, MID_PATTERN));
 
-	auto next = begin.subView(END_PATTERN.size(), CHAR_LEN);
 	res.txt = " "; // make space for lgPattern character
 	int lgPattern = 0;
 
-	CHECK(DecodeDigits(6, next, res.txt, &lgPattern));
+	CHECK(left.decode(6, res.txt, &lgPattern, &EAN13_PARITY_PREFIXES));
 
-	next = next.subView(MID_PATTERN.size(), CHAR_LEN);
+	auto next = mid.subView(MID_PATTERN.size(), CHAR_LEN);
 
 	CHECK(DecodeDigits(6, next, res.txt));
 
@@ -161,7 +231,7 @@ static bool PlausibleDigitModuleSize(PatternView begin, int start, int i, float
 	return std::abs(moduleSizeData / moduleSizeRef - 1) < 0.2f;
 }
 
-static bool EAN8(PartialResult& res, PatternView begin)
+static bool EAN8(PartialResult& res, PatternView begin, LeftDigits& left)
 {
 	auto mid = begin.subView(19, MID_PATTERN.size());
 	auto end = begin.subView(40, END_PATTERN.size());
@@ -175,12 +245,11 @@ static bool EAN8(PartialResult& res, PatternView begin)
 		for (int i = 0; i < 4; ++i)
 			CHECK(PlausibleDigitModuleSize(begin, start, i, moduleSizeGuard));
 
-	auto next = begin.subView(END_PATTERN.size(), CHAR_LEN);
 	res.txt.clear();
 
-	CHECK(DecodeDigits(4, next, res.txt));
+	CHECK(left.decode(4, res.txt));
 
-	next = next.subView(MID_PATTERN.size(), CHAR_LEN);
+	auto next = mid.subView(MID_PATTERN.size(), CHAR_LEN);
 
 	CHECK(DecodeDigits(4, next, res.txt));
 
@@ -189,7 +258,7 @@ static bool EAN8(PartialResult& res, PatternView begin)
 	return true;
 }
 
-static bool UPCE(PartialResult& res, PatternView begin)
+static bool UPCE(PartialResult& res, PatternView begin, LeftDigits& left)
 {
 	auto end = begin.subView(27, UPCE_END_PATTERN.size());
 
@@ -202,11 +271,10 @@ static bool UPCE(PartialResult& res, PatternView begin)
 	for (int i = 0; i < 6; ++i)
 		CHECK(PlausibleDigitModuleSize(begin, 3, i, moduleSizeGuard));
 
-	auto next = begin.subView(END_PATTERN.size(), CHAR_LEN);
 	int lgPattern = 0;
 	res.txt = " "; // make space for lgPattern character
 
-	CHECK(DecodeDigits(6, next, res.txt, &lgPattern));
+	CHECK(left.decode(6, res.txt, &lgPattern, &UPCE_PARITY_PREFIXES));
 
 	int i = IndexOf(UPCEANCommon::NUMSYS_AND_CHECK_DIGIT_PATTERNS, lgPattern);
 	CHECK(i != -1);
@@ -274,8 +342,10 @@ BarcodeData MultiUPCEANReader::decodePattern(int rowNumber, PatternView& next, s
 
 	PartialResult res;
 	auto begin = next;
+	LeftDigits left(begin);
 
-	if (!((((readEAN13 || readUPCA) && EAN13(res, begin)) || (readEAN8 && EAN8(res, begin)) || (readUPCE && UPCE(res, begin)))))
+	if (!((((readEAN13 || readUPCA) && EAN13(res, begin, left)) || (readEAN8 && EAN8(res, begin, left))
+		   || (readUPCE && UPCE(res, begin, left)))))
 		return {};
 
 	// ISO/IEC 15420:2009 (& GS1 General Specifications 5.1.3) states that the content for "]E0" should be 13 digits,
@@ -288,6 +358,12 @@ BarcodeData MultiUPCEANReader::decodePattern(int rowNumber, PatternView& next, s
 
 	Error error = !GTIN::IsCheckDigitValid(res.txt) ? ChecksumError() : Error();
 
+	// the caller would drop the result anyway, so skip the add-on and continue the scan behind the symbol
+	if (error && !_opts.returnErrors()) {
+		next = res.end;
+		return {};
+	}
+
 	// if we explicitly excluded EAN13, don't return an EAN13 symbol
 	if (res.format == BarcodeFormat::EAN13 && !readEAN13) {
 		if (res.txt.front() == '0')
@@ -21,9 +21,17 @@
 #include "ODMultiUPCEANReader.h"
 #include "ODTelepenReader.h"
 #include "BarcodeData.h"
+#include "ParallelFor.h"
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <numeric>
 #include <utility>
+#include <vector>
 
 #ifdef PRINT_DEBUG
 #include "BitMatrix.h"
@@ -65,71 +73,244 @@ Reader::Reader(const ReaderOptions& opts) : ZXing::Reader(opts)
 
 Reader::~Reader() = default;
 
+// a row with fewer bars and spaces (including the 2 quiet zones) can not contain any of the linear symbols
+constexpr int MIN_PROMISING_BARS = 16;
+
+// the minimal entropy (in bits) of the histogram of the bar and space widths of a row containing a linear symbol
+constexpr float MIN_WIDTH_ENTROPY = 0.7f;
+
 /**
-* We're going to examine rows from the middle outward, searching alternately above and below the
-* middle, and farther out each time. rowStep is the number of rows between each successive
-* attempt above and below the middle. So we'd scan row middle, then middle - rowStep, then
-* middle + rowStep, then middle - (2 * rowStep), etc.
-* rowStep is bigger as the image is taller, but is always at least 1. We've somewhat arbitrarily
-* decided that moving up and down by about 1/16 of the image is pretty good; we try more of the
-* image if "trying harder".
+* A cheap classifier for rows that can not contain any of the linear symbols, e.g. rows through text, texture or 2D
+* symbols, so the readers can skip them (see RowReader::minRowSize()). It returns the length of the longest sequence
+* of bars and spaces in the row without a quiet zone in between, i.e. a space that is at least twice as wide as the 3
+* elements on either side of it, or 0 if that is shorter than minSize. All symbologies combine narrow and wide
+* elements, so a row with (almost) only one width returns 0 as well.
 */
-BarcodesData DoDecode(const std::vector<std::unique_ptr<RowReader>>& readers, const BinaryBitmap& image, bool tryHarder,
-						 bool rotate, bool isPure, int maxSymbols, int minLineCount, bool returnErrors)
+static int MaxSymbolSize(const PatternRow& bars, int minSize)
 {
-	BarcodesData res;
+	const int n = Size(bars);
+	if (n - 2 < minSize)
+		return 0;
+
+	// bars[0] and bars[n - 1] are the spaces in front of the first and behind the last bar
+	constexpr int NONE = std::numeric_limits<int>::max() / 4;
+	int longest = 0, start = 1;
+	for (int i = 2; i < n - 1; i += 2) {
+		int before = i > 3 ? bars[i - 3] + bars[i - 2] + bars[i - 1] : NONE;
+		int after = i < n - 4 ? bars[i + 1] + bars[i + 2] + bars[i + 3] : NONE;
+		if (bars[i] >= 2 * std::min(before, after)) {
+			longest = std::max(longest, i - start);
+			start = i + 1;
+		}
+	}
+	longest = std::max(longest, n - 1 - start);
+	if (longest < minSize)
+		return 0;
+
+	// the histogram is built on the widths relative to the median width (in quarters of it), so the classifier does not
+	// depend on the scale of the symbol
+	std::array<uint16_t, 256> counts = {};
+	for (int i = 1; i < n - 1; ++i)
+		counts[std::min<int>(bars[i], Size(counts) - 1)]++;
+	int median = 0;
+	for (int sum = counts[0]; sum <= (n - 2) / 2; sum += counts[++median])
+		;
+	const int ref = std::max(1, median);
+
+	std::array<int, 32> histogram = {};
+	for (int i = 1; i < n - 1; ++i)
+		histogram[std::min<int>((4 * bars[i] + ref / 2) / ref, Size(histogram) - 1)]++;
+	float sum = 0;
+	for (int h : histogram)
+		if (h > 1)
+			sum += h * std::log2(float(h));
+	float entropy = std::log2(float(n - 2)) - sum / (n - 2);
+	return entropy >= MIN_WIDTH_ENTROPY ? longest : 0;
+}
 
-	std::vector<std::unique_ptr<RowReader::DecodingState>> decodingState(readers.size());
+/**
+ * Determines the order in which DoDecode scans the rows, see RowScan.
+ *
+ * MiddleOut returns every step-th row from the middle outwards. Adaptive starts with every (8 * step)-th row and
+ * then repeatedly bisects the gaps between the scanned rows down to step, but only next to promising rows, i.e.
+ * rows with enough bars and spaces to contain a symbol. Blank parts of the image are therefore only scanned coarsely.
+ */
+class RowSchedule
+{
+	static constexpr int COARSE_FACTOR = 8;
+	enum : int8_t { NOT_SCANNED = -1, BLANK = 0, PROMISING = 1 };
+
+	const int _height, _middle, _step, _maxLines;
+	int _count = 0; // number of rows popped so far
+	// Adaptive only: the remaining rows of the current level (the next one at the back) and the state of each row
+	std::vector<int> _queue;
+	std::vector<int8_t> _state;
+	// explicit list of rows (in scan order), see the second constructor
+	std::vector<int> _rows;
+
+	void queueRows(std::vector<int>&& rows)
+	{
+		std::ranges::sort(rows, std::greater{}, [this](int r) { return std::abs(r - _middle); });
+		_queue = std::move(rows);
+	}
 
-	int width = image.width();
-	int height = image.height();
+	void bisect()
+	{
+		auto isPromising = [this](int r) { return r >= 0 && r < _height && _state[r] == PROMISING; };
+		std::vector<int> rows;
+		for (int prev = -1, r = 0; r <= _height; ++r) {
+			if (r < _height && _state[r] == NOT_SCANNED)
+				continue;
+			if (r - prev >= 2 * _step && (isPromising(prev) || isPromising(r)))
+				rows.push_back((prev + r) / 2);
+			prev = r;
+		}
+		queueRows(std::move(rows));
+	}
 
-	if (rotate)
-		std::swap(width, height);
+public:
+	RowSchedule(int height, int step, int maxLines, bool adaptive)
+		: _height(height), _middle(height / 2), _step(step), _maxLines(maxLines)
+	{
+		if (!adaptive)
+			return;
+		_state.resize(height, NOT_SCANNED);
+		std::vector<int> rows;
+		for (int r = _middle % (COARSE_FACTOR * step); r < height; r += COARSE_FACTOR * step)
+			rows.push_back(r);
+		queueRows(std::move(rows));
+	}
 
-	int middle = height / 2;
-	// TODO: find a better heuristic/parameterization if maxSymbols != 1
-	int rowStep = std::max(1, height / ((tryHarder && !isPure) ? (maxSymbols == 1 ? 256 : 512) : 32));
-	int maxLines = tryHarder ?
-		height :	// Look at the whole image, not just the center
-		15;			// 15 rows spaced 1/32 apart is roughly the middle half of the image
+	/// Scans exactly the given (non-empty) list of rows in the given order, e.g. one band of a MiddleOut schedule
+	explicit RowSchedule(std::vector<int> rows)
+		: _height(0), _middle(0), _step(1), _maxLines(Size(rows)), _rows(std::move(rows))
+	{}
+
+	/// The next row to scan or -1 if there is none left
+	int row()
+	{
+		if (!_rows.empty())
+			return _count < Size(_rows) ? _rows[_count] : -1;
+		if (!_state.empty()) {
+			if (_queue.empty())
+				bisect();
+			return _queue.empty() ? -1 : _queue.back();
+		}
 
-	if (isPure)
-		minLineCount = 1;
-	else
-		minLineCount = std::min(minLineCount, height);
-	std::vector<int> checkRows;
+		if (_count >= _maxLines)
+			return -1;
+		// Scanning from the middle out. Determine which row we're looking at next:
+		int rowStepsAboveOrBelow = (_count + 1) / 2;
+		bool isAbove = (_count & 0x01) == 0; // i.e. is x even?
+		int rowNumber = _middle + _step * (isAbove ? rowStepsAboveOrBelow : -rowStepsAboveOrBelow);
+		return rowNumber < 0 || rowNumber >= _height ? -1 : rowNumber;
+	}
 
-	PatternRow bars;
-	bars.reserve(128); // e.g. EAN-13 has 59 bars/spaces
+	/// Remove the current row(), it is blank until marked as promising
+	void pop()
+	{
+		if (!_state.empty()) {
+			_state[_queue.back()] = BLANK;
+			_queue.pop_back();
+		}
+		++_count;
+	}
+
+	void markPromising(int row)
+	{
+		if (!_state.empty())
+			_state[row] = PROMISING;
+	}
+
+	/// number of rows popped so far
+	int count() const { return _count; }
+};
+
+// Extend the position of a symbol by the line from left to right, either at its top or at its bottom edge
+static void MergeLine(Position& pos, PointI left, PointI right, bool rotate)
+{
+	auto dTop = maxAbsComponent(pos.topLeft() - left);
+	auto dBot = maxAbsComponent(pos.bottomLeft() - left);
+	if (dTop < dBot || (dTop == dBot && rotate ^ (sumAbsComponent(pos[0]) > sumAbsComponent(left)))) {
+		pos[0] = left;
+		pos[1] = right;
+	} else {
+		pos[2] = right;
+		pos[3] = left;
+	}
+}
 
+static int CountSymbols(const BarcodesData& res, int minLineCount)
+{
+	return Reduce(res, 0, [&](int s, const BarcodeData& r) { return s + (r.lineCount >= minLineCount); });
+}
+
+struct ScanParams
+{
+	const BinaryBitmap& image;
+	bool tryHarder, rotate, isPure, returnErrors;
+	int width, height, rowStep, maxSymbols, minLineCount;
 #ifdef PRINT_DEBUG
-	BitMatrix dbg(width, height);
+	BitMatrix* dbg = nullptr;
 #endif
+};
 
-	for (int i = 0; i < maxLines; i++) {
+// Where ScanRows found a symbol first and how many of its lines were found in check rows, see ScanBands
+struct FirstHit
+{
+	int row;     // the scheduled row, or the one that added the check row the symbol was found in
+	int subRow;  // 0/1: found in the row itself (upright/upside down), 2: found in one of its check rows
+	const RowReader* reader;
+	int checkLines = 0;
+};
 
-		// Scanning from the middle out. Determine which row we're looking at next:
-		int rowStepsAboveOrBelow = (i + 1) / 2;
-		bool isAbove = (i & 0x01) == 0; // i.e. is x even?
-		int rowNumber = middle + rowStep * (isAbove ? rowStepsAboveOrBelow : -rowStepsAboveOrBelow);
+/**
+* Run the readers on all rows of the schedule until maxSymbols symbols have been seen in at least minLineCount
+* lines each. The returned symbols are not yet filtered by their lineCount. If firstHits is given, it receives
+* one entry per returned symbol.
+*/
+static BarcodesData ScanRows(const ScanParams& p, const std::vector<const RowReader*>& readers, RowSchedule& schedule,
+							 std::vector<FirstHit>* firstHits = nullptr)
+{
+	BarcodesData res;
+
+	std::vector<std::unique_ptr<RowReader::DecodingState>> decodingState(readers.size());
+	// rows that are too short for all readers are skipped right away
+	int minRowSize = std::numeric_limits<int>::max();
+	for (auto reader : readers)
+		minRowSize = std::min(minRowSize, reader->minRowSize());
+	std::vector<int> checkRows;
+
+	PatternRow bars;
+	bars.reserve(128); // e.g. EAN-13 has 59 bars/spaces
+	// candidate positions for the left guard patterns, built once per row and direction for all readers
+	GuardIndex guards;
+
+	int scheduledRow = -1;
+	for (int rowNumber; (rowNumber = schedule.row()) != -1;) {
+		int i = schedule.count();
 		bool isCheckRow = false;
-		if (rowNumber < 0 || rowNumber >= height) {
-			// Oops, if we run off the top or bottom, stop
-			break;
-		}
 
 		// See if we have additional check rows (see below) to process
 		if (checkRows.size()) {
-			--i;
 			rowNumber = checkRows.back();
 			checkRows.pop_back();
 			isCheckRow = true;
-			if (rowNumber < 0 || rowNumber >= height)
+			if (rowNumber < 0 || rowNumber >= p.height)
 				continue;
+		} else {
+			schedule.pop();
+			scheduledRow = rowNumber;
 		}
 
-		if (!image.getPatternRow(rowNumber, rotate ? 90 : 0, bars))
+		if (!p.image.getPatternRow(rowNumber, p.rotate ? 90 : 0, bars))
+			continue;
+
+		if (!isCheckRow && Size(bars) >= MIN_PROMISING_BARS)
+			schedule.markPromising(rowNumber);
+
+		int maxSymbolSize = MaxSymbolSize(bars, minRowSize);
+		if (maxSymbolSize == 0)
 			continue;
 
 #ifdef PRINT_DEBUG
@@ -137,7 +318,7 @@ BarcodesData DoDecode(const std::vector<std::unique_ptr<RowReader>>& readers, co
 		int x = 0;
 		for (auto b : bars) {
 			for(unsigned j = 0; j < b; ++j)
-				dbg.set(x++, rowNumber, val);
+				p.dbg->set(x++, rowNumber, val);
 			val = !val;
 		}
 #endif
@@ -154,45 +335,44 @@ BarcodesData DoDecode(const std::vector<std::unique_ptr<RowReader>>& readers, co
 				// reverse the row and continue
 				std::reverse(bars.begin(), bars.end());
 			}
+			guards.build(bars);
 			// Look for a barcode
 			for (size_t r = 0; r < readers.size(); ++r) {
 				// If this is a pure symbol, then checking a single non-empty line is sufficient for all but the stacked
 				// DataBar codes. They are the only ones using the decodingState, which we can use as a flag here.
-				if (isPure && i && !decodingState[r])
+				if (p.isPure && i && !decodingState[r])
+					continue;
+				if (maxSymbolSize < readers[r]->minRowSize())
 					continue;
+				if (!decodingState[r])
+					decodingState[r] = readers[r]->newDecodingState(p.image, p.rotate);
 
-				PatternView next(bars);
+				PatternView next(bars, &guards);
 				do {
 					BarcodeData result = readers[r]->decodePattern(rowNumber, next, decodingState[r]);
-					if (result.isValid() || (returnErrors && result.error)) {
+					if (result.isValid() || (p.returnErrors && result.error)) {
 						result.lineCount++;
 						if (upsideDown) {
 							// update position (flip horizontally).
-							for (auto& p : result.position) {
-								p = {width - p.x - 1, p.y};
+							for (auto& pt : result.position) {
+								pt = {p.width - pt.x - 1, pt.y};
 							}
 						}
-						if (rotate) {
-							for (auto& p : result.position) {
-								p = {p.y, width - p.x - 1};
+						if (p.rotate) {
+							for (auto& pt : result.position) {
+								pt = {pt.y, p.width - pt.x - 1};
 							}
 						}
 
 						// check if we know this code already
-						for (auto& other : res) {
+						for (int j = 0; j < Size(res); ++j) {
+							auto& other = res[j];
 							if (result == other) {
 								// merge the position information
-								auto dTop = maxAbsComponent(other.position.topLeft() - result.position.topLeft());
-								auto dBot = maxAbsComponent(other.position.bottomLeft() - result.position.topLeft());
-								if (dTop < dBot || (dTop == dBot && rotate ^ (sumAbsComponent(other.position[0]) >
-																			  sumAbsComponent(result.position[0])))) {
-									other.position[0] = result.position[0];
-									other.position[1] = result.position[1];
-								} else {
-									other.position[2] = result.position[2];
-									other.position[3] = result.position[3];
-								}
+								MergeLine(other.position, result.position[0], result.position[1], p.rotate);
 								other.lineCount++;
+								if (firstHits && isCheckRow)
+									(*firstHits)[j].checkLines++;
 								// clear the result, so we don't insert it again below
 								result = BarcodeData();
 								break;
@@ -201,31 +381,195 @@ BarcodesData DoDecode(const std::vector<std::unique_ptr<RowReader>>& readers, co
 
 						if (result.format != BarcodeFormat::None) {
 							res.push_back(std::move(result));
+							if (firstHits)
+								firstHits->push_back({scheduledRow, isCheckRow ? 2 : upsideDown, readers[r], isCheckRow});
 
 							// if we found a valid code we have not seen before but a minLineCount > 1,
 							// add additional check rows above and below the current one
-							if (!isCheckRow && minLineCount > 1 && rowStep > 1) {
+							if (!isCheckRow && p.minLineCount > 1 && p.rowStep > 1) {
 								checkRows = {rowNumber - 1, rowNumber + 1};
-								if (rowStep > 2)
+								if (p.rowStep > 2)
 									checkRows.insert(checkRows.end(), {rowNumber - 2, rowNumber + 2});
 							}
 						}
 
-						if (maxSymbols && Reduce(res, 0, [&](int s, const BarcodeData& r) {
-											  return s + (r.lineCount >= minLineCount);
-										  }) == maxSymbols) {
-							goto out;
-						}
+						if (p.maxSymbols && CountSymbols(res, p.minLineCount) == p.maxSymbols)
+							return res;
 					}
 					// make sure we make progress and we start the next try on a bar
 					next.shift(2 - (next.index() % 2));
 					next.extend();
-				} while (tryHarder && next.size());
+				} while (p.tryHarder && next.size());
 			}
 		}
 	}
 
-out:
+	return res;
+}
+
+// a band with fewer rows is not worth the overhead of a separate task
+constexpr int MIN_ROWS_PER_BAND = 16;
+
+/**
+* Scan the rows of the schedule in up to 2 * maxThreads horizontal bands in parallel, each with its own PatternRow
+* and check rows. The stateless readers see every row exactly once, so the union of the bands finds the same lines
+* as the serial scan. The stateful readers (the stacked DataBar symbols) combine the information of several rows,
+* which would make their result depend on the band boundaries. They run as one additional task over the whole
+* schedule instead, which keeps their result identical to the serial one.
+*
+* The partial results are merged and then sorted by the position of their first hit in the serial schedule, so the
+* list is in the same order as the serial one. Each band adds its own check rows for a symbol that is new to it,
+* only the check row lines of the band where the serial scan saw the symbol first are counted.
+*
+* The serial scan stops as soon as maxSymbols symbols have been found, which the bands can not reproduce. So this is
+* only used with maxSymbols == 0.
+*/
+static BarcodesData ScanBands(const ScanParams& p, const std::vector<const RowReader*>& readers, RowSchedule& schedule,
+							  Executor* executor, int maxThreads)
+{
+	std::vector<const RowReader*> stateless, stateful;
+	for (auto reader : readers)
+		(reader->usesDecodingState() ? stateful : stateless).push_back(reader);
+
+	std::vector<int> rows;
+	for (RowSchedule s = schedule; s.row() != -1; s.pop())
+		rows.push_back(s.row());
+
+	int numBands = std::min(Size(rows) / MIN_ROWS_PER_BAND, 2 * maxThreads);
+	if (numBands < 2 || stateless.empty())
+		return ScanRows(p, readers, schedule);
+
+	// contiguous bands of rows, each one scanned in the middle-out order of the serial schedule
+	auto sorted = rows;
+	std::ranges::sort(sorted);
+	std::vector<std::vector<int>> bands(numBands);
+	for (int row : rows) {
+		auto rank = std::ranges::lower_bound(sorted, row) - sorted.begin();
+		bands[rank * numBands / Size(rows)].push_back(row);
+	}
+
+	// the stateful task (if any) comes first as it is the longest one
+	int offset = stateful.empty() ? 0 : 1;
+	std::vector<BarcodesData> parts(numBands + offset);
+	std::vector<std::vector<FirstHit>> partHits(Size(parts));
+	ParallelFor(executor, maxThreads, Size(parts), [&](int i) {
+		if (i < offset) {
+			RowSchedule s = schedule;
+			parts[i] = ScanRows(p, stateful, s, &partHits[i]);
+		} else {
+			RowSchedule s(std::move(bands[i - offset]));
+			parts[i] = ScanRows(p, stateless, s, &partHits[i]);
+		}
+	});
+
+	// the position of a hit in the serial scan: the index of its row in the schedule, then the direction (check rows
+	// come after both), then the reader
+	std::vector<int> rowIndex(p.height, 0);
+	for (int i = 0; i < Size(rows); ++i)
+		rowIndex[rows[i]] = i;
+	auto serialOrder = [&](const FirstHit& hit) {
+		return (rowIndex[hit.row] * 3 + hit.subRow) * Size(readers) + IndexOf(readers, hit.reader);
+	};
+
+	BarcodesData res;
+	std::vector<std::pair<int, int>> resHits; // the serial order of the first hit and its check lines for each symbol
+	// The same symbol found in two neighboring bands has no overlapping bounding boxes. So, like in the serial case,
+	// we look for a known symbol that fits the top or the bottom line of the result as a single line.
+	auto findSymbol = [&res](BarcodeData& result) {
+		auto pos = std::exchange(result.position, {});
+		auto lineCount = std::exchange(result.lineCount, 1);
+		auto matches = [&](const BarcodeData& other, PointI left, PointI right) {
+			result.position = {left, right, right, left};
+			return other == result;
+		};
+		auto other = std::ranges::find_if(
+			res, [&](const BarcodeData& other) { return matches(other, pos[0], pos[1]) || matches(other, pos[3], pos[2]); });
+		result.position = pos;
+		result.lineCount = lineCount;
+		return other;
+	};
+
+	for (int i = 0; i < Size(parts); ++i)
+		for (int j = 0; j < Size(parts[i]); ++j) {
+			auto& result = parts[i][j];
+			std::pair hit(serialOrder(partHits[i][j]), partHits[i][j].checkLines);
+			auto other = findSymbol(result);
+			auto& pos = result.position;
+			if (other == res.end()) {
+				res.push_back(std::move(result));
+				resHits.push_back(hit);
+				continue;
+			}
+			MergeLine(other->position, pos[0], pos[1], p.rotate);
+			if (pos[0] != pos[3] || pos[1] != pos[2])
+				MergeLine(other->position, pos[3], pos[2], p.rotate);
+			// only keep the check lines of the earlier hit
+			auto& otherHit = resHits[other - res.begin()];
+			other->lineCount += result.lineCount - std::max(hit, otherHit).second;
+			otherHit = std::min(hit, otherHit);
+		}
+
+	std::vector<int> order(Size(res));
+	std::iota(order.begin(), order.end(), 0);
+	std::ranges::stable_sort(order, {}, [&](int i) { return resHits[i].first; });
+	BarcodesData ordered;
+	ordered.reserve(Size(res));
+	for (int i : order)
+		ordered.push_back(std::move(res[i]));
+
+	return ordered;
+}
+
+/**
+* We're going to examine rows from the middle outward, searching alternately above and below the
+* middle, and farther out each time. rowStep is the number of rows between each successive
+* attempt above and below the middle. So we'd scan row middle, then middle - rowStep, then
+* middle + rowStep, then middle - (2 * rowStep), etc.
+* rowStep is bigger as the image is taller, but is always at least 1. We've somewhat arbitrarily
+* decided that moving up and down by about 1/16 of the image is pretty good; we try more of the
+* image if "trying harder".
+*
+* If trying harder with more than one thread and without a maxSymbols limit, the rows are split into horizontal
+* bands that are scanned in parallel, see ScanBands.
+*/
+BarcodesData DoDecode(const std::vector<std::unique_ptr<RowReader>>& readers, const BinaryBitmap& image,
+					  const ReaderOptions& opts, bool rotate, int maxSymbols)
+{
+	bool tryHarder = opts.tryHarder();
+	bool isPure = opts.isPure();
+
+	int width = image.width();
+	int height = image.height();
+
+	if (rotate)
+		std::swap(width, height);
+
+	// TODO: find a better heuristic/parameterization if maxSymbols != 1
+	int rowStep = std::max(1, height / ((tryHarder && !isPure) ? (maxSymbols == 1 ? 256 : 512) : 32));
+	int maxLines = tryHarder ?
+		height :	// Look at the whole image, not just the center
+		15;			// 15 rows spaced 1/32 apart is roughly the middle half of the image
+	bool adaptive = tryHarder && !isPure && opts.rowScan() == RowScan::Adaptive;
+	RowSchedule schedule(height, rowStep, maxLines, adaptive);
+
+	int minLineCount = isPure ? 1 : std::min<int>(opts.minLineCount(), height);
+
+	ScanParams params{image, tryHarder, rotate, isPure, opts.returnErrors(), width, height, rowStep, maxSymbols, minLineCount};
+
+	std::vector<const RowReader*> rowReaders;
+	for (auto& reader : readers)
+		rowReaders.push_back(reader.get());
+
+#ifdef PRINT_DEBUG
+	BitMatrix dbg(width, height);
+	params.dbg = &dbg;
+#endif
+
+	int maxThreads = ResolveMaxThreads(opts.maxThreads());
+	auto res = maxThreads > 1 && tryHarder && !isPure && !adaptive && !maxSymbols
+				   ? ScanBands(params, rowReaders, schedule, opts.executor(), maxThreads)
+				   : ScanRows(params, rowReaders, schedule);
+
 	// remove all symbols with insufficient line count
 	std::erase_if(res, [&](auto&& r) { return r.lineCount < minLineCount; });
 
@@ -246,14 +590,18 @@ out:
 
 BarcodesData Reader::read(const BinaryBitmap& image, int maxSymbols) const
 {
-	auto resH =
-		DoDecode(_readers, image, _opts.tryHarder(), false, _opts.isPure(), maxSymbols, _opts.minLineCount(), _opts.returnErrors());
+	auto resH = DoDecode(_readers, image, _opts, false, maxSymbols);
 	if ((!maxSymbols || Size(resH) < maxSymbols) && _opts.tryRotate()) {
-		auto resV = DoDecode(_readers, image, _opts.tryHarder(), true, _opts.isPure(), maxSymbols - Size(resH),
-								 _opts.minLineCount(), _opts.returnErrors());
+		auto resV = DoDecode(_readers, image, _opts, true, maxSymbols - Size(resH));
 		resH.insert(resH.end(), std::make_move_iterator(resV.begin()), std::make_move_iterator(resV.end()));
 	}
 	return resH;
 }
 
+void Reader::newFrame()
+{
+	for (auto& reader : _readers)
+		reader->newFrame();
+}
+
 } // namespace ZXing::OneD
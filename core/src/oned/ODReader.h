@@ -26,6 +26,7 @@ public:
 	~Reader() override;
 
 	BarcodesData read(const BinaryBitmap& image, int maxSymbols) const override;
+	void newFrame() override;
 
 private:
 	std::vector<std::unique_ptr<RowReader>> _readers;
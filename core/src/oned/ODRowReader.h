@@ -13,6 +13,7 @@
 #include "ZXAlgorithms.h"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <cstddef>
@@ -40,6 +41,7 @@ RSSExp.:  v?-74d/?-41c
 
 namespace ZXing {
 
+class BinaryBitmap;
 class ReaderOptions;
 
 namespace OneD {
@@ -66,6 +68,23 @@ public:
 
 	virtual BarcodeData decodePattern(int rowNumber, PatternView& next, std::unique_ptr<DecodingState>& state) const = 0;
 
+	/// The DecodingState of a scan over the rows of the image (variant), 90 degree rotated or not, for readers that
+	/// need to know where the rows come from. The others create theirs in decodePattern() if needed.
+	virtual std::unique_ptr<DecodingState> newDecodingState(const BinaryBitmap&, bool /*rotate*/) const { return {}; }
+
+	/// Called at the start of each frame of a ReaderContext, see Reader::newFrame().
+	virtual void newFrame() {}
+
+	/// Whether decodePattern() carries information from one row to the next in its DecodingState. The result of such
+	/// a reader depends on the set and order of rows it sees, e.g. the stacked DataBar symbols.
+	virtual bool usesDecodingState() const { return false; }
+
+	/// The minimal number of consecutive bars and spaces without a quiet zone in between a row needs to contain for
+	/// decodePattern() to possibly find something in it, i.e. the size of the shortest symbol (row) of this reader.
+	/// Shorter rows are skipped, see MaxSymbolSize() in ODReader.cpp. The default fits all symbologies that consist
+	/// of elements of at most 4 modules (e.g. 4 Code 128 characters have 24).
+	virtual int minRowSize() const { return 20; }
+
 	/**
 	 * Determines how closely a set of observed counts of runs of black/white values matches a given
 	 * target pattern. This is reported as the ratio of the total variance from the expected pattern
@@ -190,20 +209,32 @@ public:
 	}
 
 	/**
-	 * @brief Lookup the pattern in the table and return the character in alphabet at the same index.
+	 * @brief Build a direct-index table from each BITS wide pattern in table to the character in alphabet at the same
+	 * index, all other patterns map to 0.
+	 */
+	template<int BITS, typename INDEX, typename ALPHABET>
+	static constexpr std::array<char, 1 << BITS> BitPatternTable(const INDEX& table, const ALPHABET& alphabet)
+	{
+		std::array<char, 1 << BITS> res = {};
+		for (int i = 0; i < Size(table); ++i)
+			res[table[i]] = alphabet[i];
+		return res;
+	}
+
+	/**
+	 * @brief Lookup the pattern in a table built by BitPatternTable.
 	 * @returns 0 if pattern is not found. Used to be -1 but that fails on systems where char is unsigned.
 	 */
-	template<typename INDEX, typename ALPHABET>
-	static char LookupBitPattern(int pattern, const INDEX& table, const ALPHABET& alphabet)
+	template<size_t N>
+	static char LookupBitPattern(int pattern, const std::array<char, N>& table)
 	{
-		int i = IndexOf(table, pattern);
-		return i == -1 ? 0 : alphabet[i];
+		return pattern >= 0 && pattern < Size(table) ? table[pattern] : 0;
 	}
 
-	template<typename INDEX, typename ALPHABET>
-	static char DecodeNarrowWidePattern(const PatternView& view, const INDEX& table, const ALPHABET& alphabet)
+	template<size_t N>
+	static char DecodeNarrowWidePattern(const PatternView& view, const std::array<char, N>& table)
 	{
-		return LookupBitPattern(NarrowWideBitPattern(view), table, alphabet);
+		return LookupBitPattern(NarrowWideBitPattern(view), table);
 	}
 };
 
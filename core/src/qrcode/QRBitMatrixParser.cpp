@@ -100,96 +100,21 @@ FormatInformation ReadFormatInformation(const BitMatrix& bitMatrix)
 
 static ByteArray ReadQRCodewords(const BitMatrix& bitMatrix, const Version& version, const FormatInformation& formatInfo)
 {
-	BitMatrix functionPattern = version.buildFunctionPattern();
+	const int mask = formatInfo.dataMask;
 
 	ByteArray result;
 	result.reserve(version.totalCodewords());
 	uint8_t currentByte = 0;
-	bool readingUp = true;
 	int bitsRead = 0;
-	int dimension = bitMatrix.height();
-	// Read columns in pairs, from right to left
-	for (int x = dimension - 1; x > 0; x -= 2) {
-		// Skip whole column with vertical timing pattern.
-		if (x == 6)
-			x--;
-		// Read alternatingly from bottom to top then top to bottom
-		for (int row = 0; row < dimension; row++) {
-			int y = readingUp ? dimension - 1 - row : row;
-			for (int col = 0; col < 2; col++) {
-				int xx = x - col;
-				// Ignore bits covered by the function pattern
-				if (!functionPattern.get(xx, y)) {
-					// Read a bit
-					AppendBit(currentByte,
-							  GetDataMaskBit(formatInfo.dataMask, xx, y) != getBit(bitMatrix, xx, y, formatInfo.isMirrored));
-					// If we've made a whole byte, save it off
-					if (++bitsRead % 8 == 0)
-						result.push_back(std::exchange(currentByte, 0));
-				}
-			}
-		}
-		readingUp = !readingUp; // switch directions
+	for (auto [x, y, masks] : version.dataModules()) {
+		AppendBit(currentByte, ((masks >> mask) & 1) != getBit(bitMatrix, x, y, formatInfo.isMirrored));
+		// If we've made a whole byte, save it off
+		if (++bitsRead % 8 == 0)
+			result.push_back(std::exchange(currentByte, 0));
 	}
-	if (Size(result) != version.totalCodewords())
-		return {};
 
-	return result;
-}
-
-static ByteArray ReadQRCodewordsModel1(const BitMatrix& bitMatrix, const Version& version, const FormatInformation& formatInfo)
-{
-	ByteArray result;
-	result.reserve(version.totalCodewords());
-	int dimension = bitMatrix.height();
-	int columns = dimension / 4 + 1 + 2;
-	for (int j = 0; j < columns; j++) {
-		if (j <= 1) { // vertical symbols on the right side
-			int rows = (dimension - 8) / 4;
-			for (int i = 0; i < rows; i++) {
-				if (j == 0 && i % 2 == 0 && i > 0 && i < rows - 1) // extension
-					continue;
-				int x = (dimension - 1) - (j * 2);
-				int y = (dimension - 1) - (i * 4);
-				uint8_t currentByte = 0;
-				for (int b = 0; b < 8; b++) {
-					AppendBit(currentByte, GetDataMaskBit(formatInfo.dataMask, x - b % 2, y - (b / 2))
-											   != getBit(bitMatrix, x - b % 2, y - (b / 2), formatInfo.isMirrored));
-				}
-				result.push_back(currentByte);
-			}
-		} else if (columns - j <= 4) { // vertical symbols on the left side
-			int rows = (dimension - 16) / 4;
-			for (int i = 0; i < rows; i++) {
-				int x = (columns - j - 1) * 2 + 1 + (columns - j == 4 ? 1 : 0); // timing
-				int y = (dimension - 1) - 8 - (i * 4);
-				uint8_t currentByte = 0;
-				for (int b = 0; b < 8; b++) {
-					AppendBit(currentByte, GetDataMaskBit(formatInfo.dataMask, x - b % 2, y - (b / 2))
-											   != getBit(bitMatrix, x - b % 2, y - (b / 2), formatInfo.isMirrored));
-				}
-				result.push_back(currentByte);
-			}
-		} else { // horizontal symbols
-			int rows = dimension / 2;
-			for (int i = 0; i < rows; i++) {
-				if (j == 2 && i >= rows - 4) // alignment & finder
-					continue;
-				if (i == 0 && j % 2 == 1 && j + 1 != columns - 4) // extension
-					continue;
-				int x = (dimension - 1) - (2 * 2) - (j - 2) * 4;
-				int y = (dimension - 1) - (i * 2) - (i >= rows - 3 ? 1 : 0); // timing
-				uint8_t currentByte = 0;
-				for (int b = 0; b < 8; b++) {
-					AppendBit(currentByte, GetDataMaskBit(formatInfo.dataMask, x - b % 4, y - (b / 4))
-											   != getBit(bitMatrix, x - b % 4, y - (b / 4), formatInfo.isMirrored));
-				}
-				result.push_back(currentByte);
-			}
-		}
-	}
-
-	result[0] &= 0xf; // ignore corner
+	if (version.isModel1())
+		result[0] &= 0xf; // ignore corner
 	if (Size(result) != version.totalCodewords())
 		return {};
 
@@ -198,7 +123,7 @@ static ByteArray ReadQRCodewordsModel1(const BitMatrix& bitMatrix, const Version
 
 static ByteArray ReadMQRCodewords(const BitMatrix& bitMatrix, const QRCode::Version& version, const FormatInformation& formatInfo)
 {
-	BitMatrix functionPattern = version.buildFunctionPattern();
+	const int mask = MQR_DATA_MASK_INDEX.at(formatInfo.dataMask);
 
 	// D3 in a Version M1 symbol, D11 in a Version M3-L symbol and D9
 	// in a Version M3-M symbol is a 2x2 square 4-module block.
@@ -210,68 +135,15 @@ static ByteArray ReadMQRCodewords(const BitMatrix& bitMatrix, const QRCode::Vers
 	ByteArray result;
 	result.reserve(version.totalCodewords());
 	uint8_t currentByte = 0;
-	bool readingUp = true;
-	int bitsRead = 0;
-	int dimension = bitMatrix.height();
-	// Read columns in pairs, from right to left
-	for (int x = dimension - 1; x > 0; x -= 2) {
-		// Read alternatingly from bottom to top then top to bottom
-		for (int row = 0; row < dimension; row++) {
-			int y = readingUp ? dimension - 1 - row : row;
-			for (int col = 0; col < 2; col++) {
-				int xx = x - col;
-				// Ignore bits covered by the function pattern
-				if (!functionPattern.get(xx, y)) {
-					// Read a bit
-					AppendBit(currentByte,
-							  GetDataMaskBit(formatInfo.dataMask, xx, y, true) != getBit(bitMatrix, xx, y, formatInfo.isMirrored));
-					++bitsRead;
-					// If we've made a whole byte, save it off; save early if 2x2 data block.
-					if (bitsRead == 8 || (bitsRead == 4 && hasD4mBlock && Size(result) == d4mBlockIndex - 1)) {
-						result.push_back(std::exchange(currentByte, 0));
-						bitsRead = 0;
-					}
-				}
-			}
-		}
-		readingUp = !readingUp; // switch directions
-	}
-	if (Size(result) != version.totalCodewords())
-		return {};
-
-	return result;
-}
-
-static ByteArray ReadRMQRCodewords(const BitMatrix& bitMatrix, const Version& version, const FormatInformation& formatInfo)
-{
-	BitMatrix functionPattern = version.buildFunctionPattern();
-
-	ByteArray result;
-	result.reserve(version.totalCodewords());
-	uint8_t currentByte = 0;
-	bool readingUp = true;
 	int bitsRead = 0;
-	const int width = bitMatrix.width();
-	const int height = bitMatrix.height();
-	// Read columns in pairs, from right to left
-	for (int x = width - 1 - 1; x > 0; x -= 2) { // Skip right edge alignment
-		// Read alternatingly from bottom to top then top to bottom
-		for (int row = 0; row < height; row++) {
-			int y = readingUp ? height - 1 - row : row;
-			for (int col = 0; col < 2; col++) {
-				int xx = x - col;
-				// Ignore bits covered by the function pattern
-				if (!functionPattern.get(xx, y)) {
-					// Read a bit
-					AppendBit(currentByte,
-							  GetDataMaskBit(formatInfo.dataMask, xx, y) != getBit(bitMatrix, xx, y, formatInfo.isMirrored));
-					// If we've made a whole byte, save it off
-					if (++bitsRead % 8 == 0)
-						result.push_back(std::exchange(currentByte, 0));
-				}
-			}
+	for (auto [x, y, masks] : version.dataModules()) {
+		AppendBit(currentByte, ((masks >> mask) & 1) != getBit(bitMatrix, x, y, formatInfo.isMirrored));
+		++bitsRead;
+		// If we've made a whole byte, save it off; save early if 2x2 data block.
+		if (bitsRead == 8 || (bitsRead == 4 && hasD4mBlock && Size(result) == d4mBlockIndex - 1)) {
+			result.push_back(std::exchange(currentByte, 0));
+			bitsRead = 0;
 		}
-		readingUp = !readingUp; // switch directions
 	}
 	if (Size(result) != version.totalCodewords())
 		return {};
@@ -283,8 +155,8 @@ ByteArray ReadCodewords(const BitMatrix& bitMatrix, const Version& version, cons
 {
 	switch (version.type()) {
 	case Type::Micro: return ReadMQRCodewords(bitMatrix, version, formatInfo);
-	case Type::rMQR: return ReadRMQRCodewords(bitMatrix, version, formatInfo);
-	case Type::Model1: return ReadQRCodewordsModel1(bitMatrix, version, formatInfo);
+	case Type::rMQR:
+	case Type::Model1:
 	case Type::Model2: return ReadQRCodewords(bitMatrix, version, formatInfo);
 	}
 
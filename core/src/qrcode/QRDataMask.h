@@ -9,6 +9,7 @@
 #include "BitMatrix.h"
 
 #include <array>
+#include <cstdint>
 #include <stdexcept>
 
 namespace ZXing::QRCode {
@@ -20,14 +21,8 @@ namespace ZXing::QRCode {
 * and j is row position. In fact, as the text says, i is row position and j is column position.</p>
 */
 
-inline bool GetDataMaskBit(int maskIndex, int x, int y, bool isMicro = false)
+constexpr bool DataMaskFormula(int maskIndex, int x, int y)
 {
-	if (isMicro) {
-		if (maskIndex < 0 || maskIndex >= 4)
-			throw std::invalid_argument("QRCode maskIndex out of range");
-		maskIndex = std::array{1, 4, 6, 7}[maskIndex]; // map from MQR to QR indices
-	}
-
 	switch (maskIndex) {
 	case 0: return (y + x) % 2 == 0;
 	case 1: return y % 2 == 0;
@@ -38,8 +33,35 @@ inline bool GetDataMaskBit(int maskIndex, int x, int y, bool isMicro = false)
 	case 6: return ((y * x) % 6) < 3;
 	case 7: return (y + x + ((y * x) % 3)) % 2 == 0;
 	}
+	return false;
+}
+
+// All 8 masks are periodic with a period of 12 in both directions (lcm of 2, 3, 4 and 6), so each of them
+// is fully described by a 12x12 tile, stored as 12 rows of 12 bits.
+inline constexpr auto DATA_MASK_TILES = [] {
+	std::array<std::array<uint16_t, 12>, 8> res = {};
+	for (int m = 0; m < 8; ++m)
+		for (int y = 0; y < 12; ++y)
+			for (int x = 0; x < 12; ++x)
+				res[m][y] |= DataMaskFormula(m, x, y) << x;
+	return res;
+}();
+
+// map from MQR to QR mask indices
+inline constexpr std::array<int, 4> MQR_DATA_MASK_INDEX = {1, 4, 6, 7};
+
+inline bool GetDataMaskBit(int maskIndex, int x, int y, bool isMicro = false)
+{
+	if (isMicro) {
+		if (maskIndex < 0 || maskIndex >= 4)
+			throw std::invalid_argument("QRCode maskIndex out of range");
+		maskIndex = MQR_DATA_MASK_INDEX[maskIndex];
+	}
+
+	if (maskIndex < 0 || maskIndex >= 8)
+		throw std::invalid_argument("QRCode maskIndex out of range");
 
-	throw std::invalid_argument("QRCode maskIndex out of range");
+	return (DATA_MASK_TILES[maskIndex][y % 12] >> (x % 12)) & 1;
 }
 
 inline bool GetMaskedBit(const BitMatrix& bits, int x, int y, int maskIndex, bool isMicro = false)
@@ -25,8 +25,9 @@
 #include <cmath>
 #include <cstdlib>
 #include <iterator>
-#include <map>
+#include <limits>
 #include <numbers>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -51,6 +52,46 @@ PatternView FindPattern(const PatternView& view)
 	});
 }
 
+/**
+ * @brief Regular grid of square cells that buckets the indices of e.g. finder patterns by their position.
+ *
+ * Points outside of the covered area are put into the closest border cell.
+ */
+class PatternGrid
+{
+	PointF _origin;
+	double _cellSize;
+	Matrix<std::vector<int>> _cells;
+
+public:
+	PatternGrid(PointF min, PointF max, double cellSize)
+		: _origin(min), _cellSize(cellSize), _cells(std::max(1, static_cast<int>(std::ceil((max.x - min.x + 1) / cellSize))),
+													 std::max(1, static_cast<int>(std::ceil((max.y - min.y + 1) / cellSize))))
+	{}
+
+	int width() const { return _cells.width(); }
+	int height() const { return _cells.height(); }
+
+	PointI cell(PointF p) const
+	{
+		return {std::clamp(static_cast<int>((p.x - _origin.x) / _cellSize), 0, width() - 1),
+				std::clamp(static_cast<int>((p.y - _origin.y) / _cellSize), 0, height() - 1)};
+	}
+
+	bool isInside(PointI cell) const { return cell.x >= 0 && cell.x < width() && cell.y >= 0 && cell.y < height(); }
+
+	/// Add idx to all cells intersecting the square of size 2 * radius around p
+	void insert(int idx, PointF p, double radius = 0)
+	{
+		auto tl = cell(p - PointF(radius, radius)), br = cell(p + PointF(radius, radius));
+		for (int y = tl.y; y <= br.y; ++y)
+			for (int x = tl.x; x <= br.x; ++x)
+				_cells(x, y).push_back(idx);
+	}
+
+	const std::vector<int>& operator()(PointI cell) const { return _cells(cell); }
+};
+
 std::vector<ConcentricPattern> FindFinderPatterns(const BitMatrix& image, bool tryHarder)
 {
 	constexpr int MIN_SKIP         = 3;           // 1 pixel/module times 3 modules/center
@@ -66,6 +107,8 @@ std::vector<ConcentricPattern> FindFinderPatterns(const BitMatrix& image, bool t
 		skip = MIN_SKIP;
 
 	std::vector<ConcentricPattern> res;
+	// the area covered by each pattern found so far, so the candidates inside of it can be skipped without a linear search
+	PatternGrid covered({0, 0}, PointF(image.width(), image.height()), 32);
 	[[maybe_unused]] int N = 0;
 	PatternRow row;
 
@@ -77,7 +120,7 @@ std::vector<ConcentricPattern> FindFinderPatterns(const BitMatrix& image, bool t
 			PointF p(next.pixelsInFront() + next[0] + next[1] + next[2] / 2.0, y + 0.5);
 
 			// make sure p is not 'inside' an already found pattern area
-			if (FindIf(res, [p](const auto& old) { return distance(p, old) < old.size / 2; }) == res.end()) {
+			if (std::ranges::none_of(covered(covered.cell(p)), [&](int i) { return distance(p, res[i]) < res[i].size / 2; })) {
 				log(p);
 				N++;
 				auto width = 2 * next.sum(); // the factor 2 allows for a maximum aspect ratio of 4:1 due to perspective distortion
@@ -89,6 +132,7 @@ std::vector<ConcentricPattern> FindFinderPatterns(const BitMatrix& image, bool t
 					log(*pattern + PointF(0, .2), 3);
 					log(*pattern - PointF(0, .2), 3);
 					assert(image.get(pattern->x, pattern->y));
+					covered.insert(Size(res), *pattern, pattern->size / 2);
 					res.push_back(*pattern);
 				}
 			}
@@ -107,14 +151,16 @@ std::vector<ConcentricPattern> FindFinderPatterns(const BitMatrix& image, bool t
 /**
  * @brief GenerateFinderPatternSets
  * @param patterns list of ConcentricPattern objects, i.e. found finder pattern squares
+ * @param maxSets maximal number of returned sets
  * @return list of plausible finder pattern sets, sorted by decreasing plausibility
  */
-FinderPatternSets GenerateFinderPatternSets(FinderPatterns& patterns)
+FinderPatternSets GenerateFinderPatternSets(FinderPatterns& patterns, int maxSets)
 {
 	std::sort(patterns.begin(), patterns.end(), [](const auto& a, const auto& b) { return a.size > b.size; });
 
 	struct {
 		int rejSize = 0;
+		int rejDist = 0;
 		int nearFPs = 0;
 		int candidates = 0;
 		int rejLegRatio = 0;
@@ -123,7 +169,23 @@ FinderPatternSets GenerateFinderPatternSets(FinderPatterns& patterns)
 		int accepted = 0;
 	} stats;
 
-	auto sets            = std::multimap<double, FinderPatternSet>();
+	// The best maxSets sets by score, ties are broken by the difference of the legs and then by the order they were found
+	// in. Instead of keeping them sorted, the worse half is only dropped whenever the list grows to twice the size, which
+	// makes accepting a set just an append.
+	struct ScoredSet
+	{
+		double score, legDiff;
+		int order;
+		FinderPatternSet set;
+		auto key() const { return std::tuple(score, legDiff, order); }
+	};
+	auto sets            = std::vector<ScoredSet>();
+	auto worstKept       = std::pair(std::numeric_limits<double>::infinity(), 0.0);
+	auto dropWorse       = [&] {
+		std::ranges::nth_element(sets, sets.begin() + maxSets - 1, {}, &ScoredSet::key);
+		sets.resize(maxSets);
+		worstKept = {sets.back().score, sets.back().legDiff};
+	};
 	auto squaredDistance = [](const auto* a, const auto* b) {
 		// The scaling of the distance based on the b/a size ratio is a very coarse compensation for the shortening effect of
 		// the camera projection on slanted symbols. The fact that the size of the finder pattern is proportional to the
@@ -149,17 +211,12 @@ FinderPatternSets GenerateFinderPatternSets(FinderPatterns& patterns)
 	auto [mY, MY] = std::ranges::minmax_element(patterns, {}, &PointF::y);
 	int medianSize = patterns[Size(patterns) / 2].size;
 	int binSize = std::max(32, medianSize * 3); // 3 for minimum symbol size of 21 modules
-	Matrix<std::vector<int>> bins(std::ceil((MX->x - mX->x + 1) / binSize), std::ceil((MY->y - mY->y + 1) / binSize));
+	PatternGrid bins({mX->x, mY->y}, {MX->x, MY->y}, binSize);
 
 	printf("medianSize=%d binSize=%d bins=(%dx%d) ", medianSize, binSize, bins.width(), bins.height());
 
-	auto bin = [&](PointF p) {
-		return PointI(std::clamp(int((p.x - mX->x) / binSize), 0, bins.width() - 1),
-					  std::clamp(int((p.y - mY->y) / binSize), 0, bins.height() - 1));
-	};
-
 	for (int idx = 0; idx < Size(patterns); ++idx)
-		bins(bin(patterns[idx])).push_back(idx);
+		bins.insert(idx, patterns[idx]);
 
 	constexpr double maxModuleCount = 177 * 1.5;
 	// manually tuned to work with e.g. https://github.com/eventualbuddha/zedbar/blob/f0d9d9fa6158c108a21f7cde42c0339fb32dff69/examples/qr-code-140-grid02.jpg
@@ -172,31 +229,47 @@ FinderPatternSets GenerateFinderPatternSets(FinderPatterns& patterns)
 	for (int i = 0; i < nbPatterns - 2; i++) {
 		const auto* c0 = &patterns[i];
 		double maxDistToC = c0->size / 7.0 * maxModuleCount;
-		auto cBin = bin(*c0);
-		int binRadius = std::ceil(maxDistToC / binSize);
+		auto cBin = bins.cell(*c0);
+		// no need to spiral further out than the grid extends
+		int binRadius = std::min<int>(std::ceil(maxDistToC / binSize), std::max(bins.width(), bins.height()));
 		candidates.clear();
 
+		int ring = 0;
 		for (auto d : Spiral(binRadius)) {
+			// only stop after a complete ring of bins and keep the nearest candidates of those, see below
+			if (candidates.size() >= maxCandidates && std::max(std::abs(d.x), std::abs(d.y)) > ring)
+				break;
+			ring = std::max(std::abs(d.x), std::abs(d.y));
+
 			auto b = cBin + d;
-			if (b.x < 0 || b.x >= bins.width() || b.y < 0 || b.y >= bins.height())
+			if (!bins.isInside(b))
 				continue;
 
 			for (int idx : bins(b)) {
 				if (idx <= i)
 					continue;
 
+				// prune the patterns that can not be part of a symbol with c0 before they take up a candidate slot
 				const auto* p = &patterns[idx];
 				if (useFilters && c0->size > p->size * 2 + 2) {
 					stats.rejSize++;
 					continue;
 				}
+				if (distance(*c0, *p) > maxDistToC) {
+					stats.rejDist++;
+					continue;
+				}
 
 				candidates.push_back(idx);
 				stats.nearFPs++;
 			}
+		}
 
-			if (candidates.size() >= maxCandidates)
-				break;
+		// the partners of c0 on a dense sheet may be in a bin the spiral visits last, so cut off by distance not by order
+		if (candidates.size() > maxCandidates) {
+			std::ranges::partial_sort(candidates, candidates.begin() + maxCandidates, {},
+									  [&](int idx) { return distance(*c0, patterns[idx]); });
+			candidates.resize(maxCandidates);
 		}
 
 		for (int u = 0; u < Size(candidates) - 1; ++u) {
@@ -205,6 +278,16 @@ FinderPatternSets GenerateFinderPatternSets(FinderPatterns& patterns)
 				int j = candidates[u];
 				int k = candidates[v];
 
+				// the same size and distance compatibility as above between the two candidates
+				if (useFilters && patterns[std::min(j, k)].size > patterns[std::max(j, k)].size * 2 + 2) {
+					stats.rejSize++;
+					continue;
+				}
+				if (distance(patterns[j], patterns[k]) > maxDistToC) {
+					stats.rejDist++;
+					continue;
+				}
+
 				// patterns is sorted descending by size (the larger the pattern, the less likely is it noise),
 				// but the geometry/size heuristics below assume a <= b <= c in size. Keep that convention by remapping indices.
 				const auto* a = &patterns[std::max(j, k)];
@@ -280,35 +363,39 @@ FinderPatternSets GenerateFinderPatternSets(FinderPatterns& patterns)
 				// Calculate a score that is used to determine wich sets are most likely to be actual finder pattern sets,
 				// the smaller the better. Prefer finder patterns that are close to each with similar distances to each other.
 				// Note: experiments incorporating cosAB_BC or the difference of the finder pattern sizes did not yield better results.
-				auto score = distAB + distBC + std::abs(distAB - distBC);
-
-				// arbitrarily limit the number of potential sets
-				// (this has performance implications while limiting the maximal number of detected symbols)
-				const size_t setSizeLimit = 256;
-				if (sets.size() < setSizeLimit || sets.crbegin()->first > score) {
+				// The score only depends on the longer leg, so on a regular sheet of symbols, a set spanning two neighbors with a
+				// shorter leg scores the same as the real one. The more isosceles one comes first.
+				auto legDiff = std::abs(distAB - distBC);
+				auto score = distAB + distBC + legDiff;
+
+				// limit the number of potential sets (this has performance implications while limiting the maximal number of
+				// detected symbols)
+				if (std::pair(score, legDiff) < worstKept) {
 					// Use cross product to figure out whether A and C are correct or flipped.
 					// This asks whether BC x BA has a positive z component, which is the arrangement
 					// we want for A, B, C. If it's negative then swap A and C.
 					if (cross(*c - *b, *a - *b) < 0)
 						std::swap(a, c);
 
-					sets.emplace(score, FinderPatternSet{*a, *b, *c});
-					if (sets.size() > setSizeLimit)
-						sets.erase(std::prev(sets.end()));
-					stats.accepted++;
+					sets.push_back({score, legDiff, stats.accepted++, FinderPatternSet{*a, *b, *c}});
+					if (Size(sets) == 2 * maxSets)
+						dropWorse();
 				}
 			}
 		}
 	}
 
-	printf("rejectSize=%d nearFPs=%d candidates=%d rejectLeg=%d rejectMod=%d rejectAng=%d accepted=%d\n", stats.rejSize,
-		   stats.nearFPs, stats.candidates, stats.rejLegRatio, stats.rejModCount, stats.rejAngle, stats.accepted);
+	printf("rejectSize=%d rejectDist=%d nearFPs=%d candidates=%d rejectLeg=%d rejectMod=%d rejectAng=%d accepted=%d\n",
+		   stats.rejSize, stats.rejDist, stats.nearFPs, stats.candidates, stats.rejLegRatio, stats.rejModCount, stats.rejAngle, stats.accepted);
+
+	if (Size(sets) > maxSets)
+		dropWorse();
+	std::ranges::sort(sets, {}, &ScoredSet::key);
 
-	// convert from multimap to vector
 	FinderPatternSets res;
 	res.reserve(sets.size());
-	for (auto& [d, s] : sets)
-		res.push_back(s);
+	for (auto& s : sets)
+		res.push_back(s.set);
 
 	printf("FPSets: %d\n", Size(res));
 
@@ -521,6 +608,10 @@ DetectorResults SampleQR(const BitMatrix& image, const FinderPatternSet& fp)
 			mod2Pix = Mod2Pix(dimension, brOffset, {fp.tl, fp.tr, br, fp.bl});
 		}
 
+		// Sample progressively: most symbols are flat enough to be decoded with the global perspective transform. Only
+		// if that fails, the caller resumes this generator and we locate all the alignment patterns for a tiled sampling.
+		co_yield SampleGrid(image, dimension, dimension, mod2Pix);
+
 #if 1 // finding and evaluating the alignment patterns to enable a tiled sampling of the symbol
 
 		auto& apM = version->alignmentPatternCenters(); // alignment pattern positions in modules
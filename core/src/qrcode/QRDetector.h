@@ -29,7 +29,7 @@ using FinderPatterns = std::vector<ConcentricPattern>;
 using FinderPatternSets = std::vector<FinderPatternSet>;
 
 FinderPatterns FindFinderPatterns(const BitMatrix& image, bool tryHarder);
-FinderPatternSets GenerateFinderPatternSets(FinderPatterns& patterns);
+FinderPatternSets GenerateFinderPatternSets(FinderPatterns& patterns, int maxSets = 256);
 
 using DetectorResults = std::generator<DetectorResult>;
 
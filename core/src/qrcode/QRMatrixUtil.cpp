@@ -7,7 +7,6 @@
 #include "QRMatrixUtil.h"
 
 #include "BitArray.h"
-#include "QRDataMask.h"
 #include "QRErrorCorrectionLevel.h"
 #include "QRVersion.h"
 
@@ -252,45 +251,25 @@ static void EmbedVersionInfo(const Version& version, TritMatrix& matrix)
 
 // Embed "dataBits" using "getMaskPattern". On success, modify the matrix and return true.
 // For debugging purposes, it skips masking process if "getMaskPattern" is -1.
-// See 8.7 of JISX0510:2004 (p.38) for how to embed data bits.
-static void EmbedDataBits(const BitArray& dataBits, int maskPattern, TritMatrix& matrix)
+// See 8.7 of JISX0510:2004 (p.38) for how to embed data bits. The placement order of the data modules (zigzag
+// from the bottom right cell, skipping the function patterns) is precomputed per version.
+static void EmbedDataBits(const BitArray& dataBits, int maskPattern, const Version& version, TritMatrix& matrix)
 {
-	int bitIndex = 0;
-	int direction = -1;
-	// Start from the right bottom cell.
-	int x = matrix.width() - 1;
-	int y = matrix.height() - 1;
-	while (x > 0) {
-		// Skip the vertical timing pattern.
-		if (x == 6) {
-			x -= 1;
-		}
-		while (y >= 0 && y < matrix.height()) {
-			for (int xx = x; xx > x - 2; --xx) {
-				// Skip the cell if it's not empty.
-				if (!matrix.get(xx, y).isEmpty()) {
-					continue;
-				}
-				// Padding bit. If there is no bit left, we'll fill the left cells with 0, as described
-				// in 8.4.9 of JISX0510:2004 (p. 24).
-				bool bit = bitIndex < dataBits.size() ? dataBits.get(bitIndex) : false;
-				++bitIndex;
-
-				// Skip masking if mask_pattern is -1.
-				if (maskPattern != -1 && GetDataMaskBit(maskPattern, xx, y)) {
-					bit = !bit;
-				}
-				matrix.set(xx, y, bit);
-			}
-			y += direction;
-		}
-		direction = -direction;  // Reverse the direction.
-		y += direction;
-		x -= 2;  // Move to the left.
-	}
+	auto& modules = version.dataModules();
 	// All bits should be consumed.
-	if (bitIndex < dataBits.size()) {
-		throw std::invalid_argument("Not all bits consumed: " + std::to_string(bitIndex) + '/' + std::to_string(dataBits.size()));
+	if (Size(modules) < dataBits.size())
+		throw std::invalid_argument("Not all bits consumed: " + std::to_string(Size(modules)) + '/' + std::to_string(dataBits.size()));
+
+	for (int bitIndex = 0; bitIndex < Size(modules); ++bitIndex) {
+		auto [x, y, masks] = modules[bitIndex];
+		// Padding bit. If there is no bit left, we'll fill the left cells with 0, as described
+		// in 8.4.9 of JISX0510:2004 (p. 24).
+		bool bit = bitIndex < dataBits.size() ? dataBits.get(bitIndex) : false;
+
+		// Skip masking if mask_pattern is -1.
+		if (maskPattern != -1 && (masks >> maskPattern) & 1)
+			bit = !bit;
+		matrix.set(x, y, bit);
 	}
 }
 
@@ -312,7 +291,7 @@ void BuildMatrix(const BitArray& dataBits, ErrorCorrectionLevel ecLevel, const V
 	// Version info appear if version >= 7.
 	EmbedVersionInfo(version, matrix);
 	// Data should be embedded at end.
-	EmbedDataBits(dataBits, maskPattern, matrix);
+	EmbedDataBits(dataBits, maskPattern, version, matrix);
 }
 
 } // namespace ZXing::QRCode
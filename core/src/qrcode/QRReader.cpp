@@ -13,11 +13,17 @@
 #include "DecoderResult.h"
 #include "DetectorResult.h"
 #include "LogMatrix.h"
+#include "ParallelFor.h"
 #include "QRDecoder.h"
 #include "QRDetector.h"
 #include "ReaderOptions.h"
+#include "ZXAlgorithms.h"
 
+#include <algorithm>
+#include <mutex>
+#include <optional>
 #include <utility>
+#include <vector>
 
 namespace ZXing::QRCode {
 
@@ -58,6 +64,73 @@ void logFPSet(const FinderPatternSet& fps [[maybe_unused]])
 #endif
 }
 
+/**
+ * Call read(i) for all i in [0, n) that skip(i) does not exclude and pass the results to merge(i, result) strictly in the
+ * order of i, until merge returns true. If maxThreads allows it, the read() calls run concurrently and speculatively, i.e.
+ * before the results of the lower indices are merged. skip(i) and merge() are always called under a lock, and skip(i)
+ * must stay true once it was true, so the outcome is the same as that of the serial loop.
+ */
+template <typename Read, typename Skip, typename Merge>
+static void ReadInOrder(const ReaderOptions& opts, int n, Read&& read, Skip&& skip, Merge&& merge)
+{
+	int maxThreads = ResolveMaxThreads(opts.maxThreads());
+	if (maxThreads == 1 || n < 2) {
+		for (int i = 0; i < n; ++i)
+			if (!skip(i) && merge(i, read(i)))
+				return;
+		return;
+	}
+
+	std::vector<std::optional<decltype(read(0))>> results(n);
+	std::mutex mutex;
+	int merged = 0;
+	bool done = false;
+
+	ParallelFor(opts.executor(), maxThreads, n, [&](int i) {
+		bool skipped;
+		{
+			std::scoped_lock lock(mutex);
+			skipped = done || skip(i);
+		}
+		auto res = skipped ? decltype(read(0)){} : read(i);
+
+		std::scoped_lock lock(mutex);
+		results[i] = std::move(res);
+		for (; !done && merged < n && results[merged]; ++merged)
+			if (!skip(merged))
+				done = merge(merged, std::move(*results[merged]));
+	});
+}
+
+// The symbol found with one finder pattern set
+struct FPSetResult
+{
+	std::optional<BarcodeData> symbol;
+	bool used = false; // one of the symbols was valid, so the finder patterns are not tried again
+};
+
+static FPSetResult ReadFPSet(const BitMatrix& binImg, const FinderPatternSet& fpSet, const ReaderOptions& opts)
+{
+	logFPSet(fpSet);
+
+	FPSetResult res;
+	for (auto&& detectorResult : SampleQR(binImg, fpSet)) {
+		auto decoderResult = Decode(detectorResult.bits());
+		if ((decoderResult.content().symbology.modifier == '0' && !opts.hasFormat(BarcodeFormat::QRCodeModel1))
+			|| (decoderResult.content().symbology.modifier == '1' && !opts.hasFormat(BarcodeFormat::QRCodeModel2)))
+			continue;
+		res.used |= decoderResult.isValid();
+		if (decoderResult.isValid(opts.returnErrors())) {
+			// a later (more accurate) sample of the same symbol supersedes a previously failed one
+			res.symbol = MatrixBarcode(std::move(decoderResult), std::move(detectorResult), BarcodeFormat::QRCode);
+			// if we found a valid symbol, we stop the inner loop
+			if (res.symbol->isValid())
+				break;
+		}
+	}
+	return res;
+}
+
 BarcodesData Reader::read(const BinaryBitmap& image, int maxSymbols) const
 {
 	auto binImg = image.getBitMatrix();
@@ -75,73 +148,62 @@ BarcodesData Reader::read(const BinaryBitmap& image, int maxSymbols) const
 
 	std::vector<ConcentricPattern> usedFPs;
 	BarcodesData res;
-	
+	auto isFull = [&] { return maxSymbols && Size(res) == maxSymbols; };
+
+	// On a dense sheet, the sets spanning neighboring symbols score as well as the real ones, so a few sets per symbol are
+	// needed to find them all. The number of sets is limited by the number of symbols to look for, and the sampling stops
+	// as soon as the sets tried so far turned out to be mostly noise (e.g. on a texture full of finder pattern candidates).
+	constexpr int MIN_SETS = 256, SETS_PER_SYMBOL = 4;
+	auto isExhausted = [&](int i) { return i + 1 >= MIN_SETS + SETS_PER_SYMBOL * Size(res); };
+
+	// The candidates are sampled and decoded concurrently if maxThreads allows it. Only the bookkeeping of the used
+	// finder patterns depends on the previous candidates, it is resolved in the serial order afterwards.
 	if (_opts.hasFormat(BarcodeFormat::QRCodeModel1 | BarcodeFormat::QRCodeModel2)) {
-		auto allFPSets = GenerateFinderPatternSets(allFPs);
-		for (const auto& fpSet : allFPSets) {
-			if (Contains(usedFPs, fpSet.bl) || Contains(usedFPs, fpSet.tl) || Contains(usedFPs, fpSet.tr))
-				continue;
-
-			logFPSet(fpSet);
-
-			for (auto&& detectorResult: SampleQR(*binImg, fpSet)) {
-				auto decoderResult = Decode(detectorResult.bits());
-				if ((decoderResult.content().symbology.modifier == '0' && !_opts.hasFormat(BarcodeFormat::QRCodeModel1))
-					|| (decoderResult.content().symbology.modifier == '1' && !_opts.hasFormat(BarcodeFormat::QRCodeModel2)))
-					continue;
-				if (decoderResult.isValid()) {
-					usedFPs.push_back(fpSet.bl);
-					usedFPs.push_back(fpSet.tl);
-					usedFPs.push_back(fpSet.tr);
+		auto allFPSets = GenerateFinderPatternSets(allFPs, MIN_SETS + SETS_PER_SYMBOL * std::min(maxSymbols, 0xff));
+		ReadInOrder(
+			_opts, Size(allFPSets), [&](int i) { return ReadFPSet(*binImg, allFPSets[i], _opts); },
+			[&](int i) {
+				const auto& fpSet = allFPSets[i];
+				return Contains(usedFPs, fpSet.bl) || Contains(usedFPs, fpSet.tl) || Contains(usedFPs, fpSet.tr);
+			},
+			[&](int i, FPSetResult&& r) {
+				if (r.used) {
+					usedFPs.push_back(allFPSets[i].bl);
+					usedFPs.push_back(allFPSets[i].tl);
+					usedFPs.push_back(allFPSets[i].tr);
 				}
-				if (decoderResult.isValid(_opts.returnErrors())) {
-					res.emplace_back(MatrixBarcode(std::move(decoderResult), std::move(detectorResult), BarcodeFormat::QRCode));
-					// if we found a valid symbol, we stop the inner loop
-					if (res.back().isValid() || (maxSymbols && Size(res) == maxSymbols))
-						break;
-				}
-			}
-			if (maxSymbols && Size(res) == maxSymbols)
-				break;
-		}
+				if (r.symbol)
+					res.push_back(std::move(*r.symbol));
+				return isFull() || isExhausted(i);
+			});
 	}
-	
-	if (_opts.hasFormat(BarcodeFormat::MicroQRCode) && !(maxSymbols && Size(res) == maxSymbols)) {
-		for (const auto& fp : allFPs) {
-			if (Contains(usedFPs, fp))
-				continue;
-
-			auto detectorResult = SampleMQR(*binImg, fp);
-			if (detectorResult.isValid()) {
-				auto decoderResult = Decode(detectorResult.bits());
-				if (decoderResult.isValid(_opts.returnErrors())) {
-					res.emplace_back(MatrixBarcode(std::move(decoderResult), std::move(detectorResult), BarcodeFormat::MicroQRCode));
-					if (maxSymbols && Size(res) == maxSymbols)
-						break;
-				}
 
-			}
-		}
-	}
-	
-	if (_opts.hasFormat(BarcodeFormat::RMQRCode) && !(maxSymbols && Size(res) == maxSymbols)) {
-		// TODO proper
-		for (const auto& fp : allFPs) {
-			if (Contains(usedFPs, fp))
-				continue;
-
-			auto detectorResult = SampleRMQR(*binImg, fp);
-			if (detectorResult.isValid()) {
-				auto decoderResult = Decode(detectorResult.bits());
-				if (decoderResult.isValid(_opts.returnErrors())) {
-					res.emplace_back(MatrixBarcode(std::move(decoderResult), std::move(detectorResult), BarcodeFormat::RMQRCode));
-					if (maxSymbols && Size(res) == maxSymbols)
-						break;
+	auto readSingleFPs = [&](BarcodeFormat format, auto sample) {
+		if (!_opts.hasFormat(format) || isFull())
+			return;
+		// usedFPs does not change anymore, so the candidates are independent
+		ReadInOrder(
+			_opts, Size(allFPs),
+			[&](int i) {
+				std::optional<BarcodeData> symbol;
+				auto detectorResult = sample(*binImg, allFPs[i]);
+				if (detectorResult.isValid()) {
+					auto decoderResult = Decode(detectorResult.bits());
+					if (decoderResult.isValid(_opts.returnErrors()))
+						symbol = MatrixBarcode(std::move(decoderResult), std::move(detectorResult), format);
 				}
+				return symbol;
+			},
+			[&](int i) { return Contains(usedFPs, allFPs[i]); },
+			[&](int, std::optional<BarcodeData>&& symbol) {
+				if (symbol)
+					res.push_back(std::move(*symbol));
+				return isFull();
+			});
+	};
 
-			}
-		}
-	}
+	readSingleFPs(BarcodeFormat::MicroQRCode, SampleMQR);
+	readSingleFPs(BarcodeFormat::RMQRCode, SampleRMQR); // TODO proper
 
 	return res;
 }
@@ -9,10 +9,12 @@
 #include "QRVersion.h"
 
 #include "BitMatrix.h"
+#include "QRDataMask.h"
 #include "QRECB.h"
 
 #include <bit>
 #include <limits>
+#include <mutex>
 
 namespace ZXing::QRCode {
 
@@ -751,4 +753,92 @@ BitMatrix Version::buildFunctionPattern() const
 	return bitMatrix;
 }
 
+static DataModule MakeDataModule(int x, int y)
+{
+	uint8_t masks = 0;
+	for (int i = 0; i < 8; ++i)
+		masks |= GetDataMaskBit(i, x, y) << i;
+	return {narrow_cast<uint8_t>(x), narrow_cast<uint8_t>(y), masks};
+}
+
+// Model 2, Micro and rMQR symbols place their codewords in a zigzag pattern of 2 module wide columns, skipping
+// every module covered by the function pattern.
+static std::vector<DataModule> ZigZagLayout(const Version& version, const BitMatrix& functionPattern)
+{
+	std::vector<DataModule> res;
+	bool readingUp = true;
+	const int width = functionPattern.width();
+	const int height = functionPattern.height();
+	// Read columns in pairs, from right to left (skip the right edge alignment in rMQR)
+	for (int x = width - 1 - version.isRMQR(); x > 0; x -= 2) {
+		// Skip whole column with vertical timing pattern.
+		if (version.isModel2() && x == 6)
+			x--;
+		// Read alternatingly from bottom to top then top to bottom
+		for (int row = 0; row < height; row++) {
+			int y = readingUp ? height - 1 - row : row;
+			for (int col = 0; col < 2; col++) {
+				int xx = x - col;
+				// Ignore bits covered by the function pattern
+				if (!functionPattern.get(xx, y))
+					res.push_back(MakeDataModule(xx, y));
+			}
+		}
+		readingUp = !readingUp; // switch directions
+	}
+
+	return res;
+}
+
+// Model 1 symbols place each codeword in a 2x4 or 4x2 block, the blocks are listed here in codeword order.
+static std::vector<DataModule> Model1Layout(const Version& version)
+{
+	std::vector<DataModule> res;
+	auto addBlock = [&res](int x, int y, int w) {
+		for (int b = 0; b < 8; b++)
+			res.push_back(MakeDataModule(x - b % w, y - (b / w)));
+	};
+
+	int dimension = version.dimension();
+	int columns = dimension / 4 + 1 + 2;
+	for (int j = 0; j < columns; j++) {
+		if (j <= 1) { // vertical symbols on the right side
+			int rows = (dimension - 8) / 4;
+			for (int i = 0; i < rows; i++) {
+				if (j == 0 && i % 2 == 0 && i > 0 && i < rows - 1) // extension
+					continue;
+				addBlock((dimension - 1) - (j * 2), (dimension - 1) - (i * 4), 2);
+			}
+		} else if (columns - j <= 4) { // vertical symbols on the left side
+			int rows = (dimension - 16) / 4;
+			for (int i = 0; i < rows; i++)
+				addBlock((columns - j - 1) * 2 + 1 + (columns - j == 4 ? 1 : 0), (dimension - 1) - 8 - (i * 4), 2); // timing
+		} else { // horizontal symbols
+			int rows = dimension / 2;
+			for (int i = 0; i < rows; i++) {
+				if (j == 2 && i >= rows - 4) // alignment & finder
+					continue;
+				if (i == 0 && j % 2 == 1 && j + 1 != columns - 4) // extension
+					continue;
+				addBlock((dimension - 1) - (2 * 2) - (j - 2) * 4, (dimension - 1) - (i * 2) - (i >= rows - 3 ? 1 : 0), 4); // timing
+			}
+		}
+	}
+
+	return res;
+}
+
+const std::vector<DataModule>& Version::dataModules() const
+{
+	constexpr int N = 40; // max version number of any type
+	static std::array<std::once_flag, 4 * N> once;
+	static std::array<std::vector<DataModule>, 4 * N> layouts;
+
+	int i = static_cast<int>(type()) * N + versionNumber() - 1;
+	std::call_once(once[i], [&] {
+		layouts[i] = isModel1() ? Model1Layout(*this) : ZigZagLayout(*this, buildFunctionPattern());
+	});
+	return layouts[i];
+}
+
 } // namespace ZXing::QRCode
@@ -13,6 +13,7 @@
 #include "ZXAlgorithms.h"
 
 #include <array>
+#include <cstdint>
 #include <initializer_list>
 #include <vector>
 
@@ -33,6 +34,15 @@ constexpr std::array<PointI, 32> RMQR_SIZES {
 };
 // clang-format on
 
+/**
+* A data module of a symbol together with the value of all 8 QR data masks at its position.
+*/
+struct DataModule
+{
+	uint8_t x, y;
+	uint8_t masks; // bit i is set if QR data mask i is set at (x, y)
+};
+
 /**
 * See ISO 18004:2006 Annex D
 */
@@ -57,6 +67,10 @@ public:
 
 	BitMatrix buildFunctionPattern() const;
 
+	// The list of data modules in codeword placement order only depends on the version. It is built on first use and
+	// cached for the lifetime of the program, hence it can be shared between threads.
+	const std::vector<DataModule>& dataModules() const;
+
 	static constexpr PointI SymbolSize(int version, Type type)
 	{
 		auto square = [](int s) { return PointI(s, s); };
@@ -48,11 +48,14 @@ static void PrintUsage(const char* exePath)
 			  << "    -norotate  Don't try rotated image during detection (faster)\n"
 			  << "    -noinvert  Don't search for inverted codes during detection (faster)\n"
 			  << "    -noscale   Don't try downscaled images during detection (faster)\n"
+			  << "    -adaptive  Scan the rows of linear codes coarse to fine, skipping blank areas (faster)\n"
 			  << "    -formats <FORMAT[,...]>\n"
 			  << "               Only detect given format(s) (faster)\n"
 			  << "    -single    Stop after the first barcode is detected (faster)\n"
 			  << "    -ispure    Assume the image contains only a 'pure'/perfect code (faster)\n"
 			  << "    -errors    Include barcodes with errors (like checksum error)\n"
+			  << "    -threads <n>\n"
+			  << "               Use up to n threads per image (0 = one per hardware thread)\n"
 			  << "    -binarizer <local|global|fixed>\n"
 			  << "               Binarizer to be used for gray to binary conversion\n"
 			  << "    -mode <plain|eci|hri|escaped>\n"
@@ -87,6 +90,8 @@ static bool ParseOptions(int argc, char* argv[], ReaderOptions& options, CLI& cl
 		auto is = [&](const char* str) { return strlen(argv[i]) > 1 && strncmp(argv[i], str, strlen(argv[i])) == 0; };
 		if (is("-fast")) {
 			options.tryHarder(false);
+		} else if (is("-adaptive")) {
+			options.rowScan(RowScan::Adaptive);
 		} else if (is("-norotate")) {
 			options.tryRotate(false);
 		} else if (is("-noinvert")) {
@@ -104,6 +109,10 @@ static bool ParseOptions(int argc, char* argv[], ReaderOptions& options, CLI& cl
 			options.binarizer(Binarizer::FixedThreshold);
 		} else if (is("-errors")) {
 			options.returnErrors(true);
+		} else if (is("-threads")) {
+			if (++i == argc)
+				return false;
+			options.maxThreads(std::stoi(argv[i]));
 		} else if (is("-formats")) {
 			if (++i == argc)
 				return false;
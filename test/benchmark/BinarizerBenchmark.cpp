@@ -0,0 +1,53 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BitMatrix.h"
+#include "HybridBinarizer.h"
+#include "ThreadPool.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace ZXing;
+
+// A 1920x1080 frame with the luminance in every pixStride-th byte
+static void BM_HybridBinarizer(benchmark::State& state)
+{
+	const int width = 1920, height = 1080, pixStride = narrow_cast<int>(state.range(0));
+	std::minstd_rand rand(42);
+	std::vector<uint8_t> buf(width * height * pixStride);
+	for (int i = 0; i < width * height; ++i)
+		buf[i * pixStride] = (i / 7 + i / width / 5) % 2 ? 40 + rand() % 30 : 180 + rand() % 30;
+	const ImageView iv(buf.data(), width, height, ImageFormat::Lum, width * pixStride, pixStride);
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(HybridBinarizer(iv).getBitMatrix());
+
+	state.SetItemsProcessed(state.iterations() * width * height);
+}
+BENCHMARK(BM_HybridBinarizer)->Arg(1)->Arg(2);
+
+// A 3840x2160 frame binarized in row bands on range(0) threads
+static void BM_HybridBinarizerThreads(benchmark::State& state)
+{
+	const int width = 3840, height = 2160, threads = narrow_cast<int>(state.range(0));
+	std::minstd_rand rand(42);
+	std::vector<uint8_t> buf(width * height);
+	for (int i = 0; i < width * height; ++i)
+		buf[i] = (i / 7 + i / width / 5) % 2 ? 40 + rand() % 30 : 180 + rand() % 30;
+	const ImageView iv(buf.data(), width, height, ImageFormat::Lum);
+	ThreadPool pool(threads);
+
+	for (auto _ : state) {
+		HybridBinarizer bin(iv);
+		bin.setConcurrency(&pool, threads);
+		benchmark::DoNotOptimize(bin.getBitMatrix());
+	}
+
+	state.SetItemsProcessed(state.iterations() * width * height);
+}
+BENCHMARK(BM_HybridBinarizerThreads)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
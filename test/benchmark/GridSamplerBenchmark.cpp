@@ -0,0 +1,56 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+// The numbers of interest are the differences between a build with and without -DZXING_BOUNDS_CHECKS=ON.
+
+#include "BitMatrix.h"
+#include "BitMatrixCursor.h"
+#include "GridSampler.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+using namespace ZXing;
+
+static BitMatrix RandomImage(int size)
+{
+	std::minstd_rand rand(42);
+	BitMatrix res(size);
+	for (int y = 0; y < size; ++y)
+		for (int x = 0; x < size; ++x)
+			res.set(x, y, rand() & 1);
+	return res;
+}
+
+static void BM_SampleGrid(benchmark::State& state)
+{
+	const int dim = narrow_cast<int>(state.range(0));
+	const auto image = RandomImage(1000);
+	// a slightly perspective distorted quadrilateral inside the image
+	const PerspectiveTransform mod2Pix(Rectangle<PointF>(dim, dim), {PointF{100, 120}, {880, 90}, {900, 910}, {80, 870}});
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(SampleGrid(image, dim, dim, mod2Pix));
+
+	state.SetItemsProcessed(state.iterations() * dim * dim);
+}
+BENCHMARK(BM_SampleGrid)->Arg(21)->Arg(57)->Arg(177);
+
+static void BM_CursorStepToEdge(benchmark::State& state)
+{
+	const auto image = RandomImage(1000);
+
+	for (auto _ : state) {
+		int edges = 0;
+		for (int y = 0; y < image.height(); y += 10) {
+			BitMatrixCursorI cur(image, {0, y}, {1, 0});
+			while (cur.stepToEdge())
+				++edges;
+		}
+		benchmark::DoNotOptimize(edges);
+	}
+}
+BENCHMARK(BM_CursorStepToEdge);
@@ -0,0 +1,31 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "LumImage.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace ZXing;
+
+static void BM_ExtractLum(benchmark::State& state, ImageFormat format)
+{
+	const int width = 1920, height = 1080;
+	std::minstd_rand rand(42);
+	std::vector<uint8_t> buf(width * height * PixStride(format));
+	for (auto& v : buf)
+		v = static_cast<uint8_t>(rand());
+	const ImageView iv(buf.data(), width, height, format);
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(ExtractLum(iv));
+
+	state.SetItemsProcessed(state.iterations() * width * height);
+}
+BENCHMARK_CAPTURE(BM_ExtractLum, RGB, ImageFormat::RGB);
+BENCHMARK_CAPTURE(BM_ExtractLum, BGRA, ImageFormat::BGRA);
+BENCHMARK_CAPTURE(BM_ExtractLum, UYVY, ImageFormat::UYVY);
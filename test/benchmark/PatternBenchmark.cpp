@@ -0,0 +1,55 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Pattern.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace ZXing;
+
+// A binarized 1920 pixel row with runs of 1 to range(0) pixels
+static std::vector<uint8_t> BinarizedRow(int maxRun)
+{
+	std::minstd_rand rand(42);
+	std::vector<uint8_t> row(1920);
+	uint8_t v = 0;
+	for (size_t x = 0; x < row.size(); v = ~v)
+		for (int n = 1 + rand() % maxRun; n && x < row.size(); --n)
+			row[x++] = v;
+	return row;
+}
+
+static void BM_GetPatternRow(benchmark::State& state)
+{
+	const auto row = BinarizedRow(narrow_cast<int>(state.range(0)));
+	PatternRow res;
+
+	for (auto _ : state) {
+		GetPatternRow(Range{row}, res);
+		benchmark::DoNotOptimize(res.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * row.size());
+}
+BENCHMARK(BM_GetPatternRow)->ArgName("maxRun")->Arg(4)->Arg(16)->Arg(128);
+
+// The same rows accessed through a StrideIter, which is processed one pixel at a time
+static void BM_GetPatternRowStrided(benchmark::State& state)
+{
+	const auto row = BinarizedRow(narrow_cast<int>(state.range(0)));
+	const Range<StrideIter<const uint8_t*>> line = {{row.data(), 1}, {row.data() + row.size(), 1}};
+	PatternRow res;
+
+	for (auto _ : state) {
+		GetPatternRow(line, res);
+		benchmark::DoNotOptimize(res.data());
+	}
+
+	state.SetItemsProcessed(state.iterations() * row.size());
+}
+BENCHMARK(BM_GetPatternRowStrided)->ArgName("maxRun")->Arg(4)->Arg(16)->Arg(128);
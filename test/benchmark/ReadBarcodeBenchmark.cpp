@@ -0,0 +1,426 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BarcodeTracker.h"
+#include "BitMatrix.h"
+#include "ReadBarcode.h"
+#include "ReaderContext.h"
+#include "ReaderOptions.h"
+#include "oned/ODCode128Reader.h"
+#include "oned/ODCode128Writer.h"
+#include "oned/ODCode39Reader.h"
+#include "oned/ODCode39Writer.h"
+#include "oned/ODCode93Reader.h"
+#include "oned/ODCode93Writer.h"
+#include "oned/ODEAN13Writer.h"
+#include "oned/ODEAN8Writer.h"
+#include "oned/ODMultiUPCEANReader.h"
+#include "oned/ODUPCEWriter.h"
+#include "qrcode/QRDecoder.h"
+#include "qrcode/QRWriter.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace ZXing;
+
+// A white image to draw the symbols and the clutter of the benchmark scenes on
+struct Canvas
+{
+	int width, height;
+	ImageFormat format;
+	std::vector<uint8_t> buf;
+
+	Canvas(int w, int h, ImageFormat f = ImageFormat::Lum) : width(w), height(h), format(f), buf(w * h * PixStride(f), 0xff) {}
+
+	void fill(int left, int top, int w, int h, uint8_t value = 0)
+	{
+		for (int y = top; y < top + h; ++y)
+			std::fill_n(&buf[(y * width + left) * PixStride(format)], w * PixStride(format), value);
+	}
+
+	void draw(const BitMatrix& bits, int left, int top)
+	{
+		for (int y = 0; y < bits.height(); ++y)
+			for (int x = 0; x < bits.width(); ++x)
+				if (bits.get(x, y))
+					fill(left + x, top + y, 1, 1);
+	}
+
+	ImageView view() const { return {buf.data(), width, height, format}; }
+};
+
+// A small 320x240 RGB frame with a QR code, where the per call setup is a significant part of the work
+static Canvas SmallFrame()
+{
+	Canvas res(320, 240, ImageFormat::RGB);
+	res.draw(QRCode::Writer().setMargin(0).encode(L"ReaderContext", 120, 120), 100, 60);
+	return res;
+}
+
+static void BM_ReadBarcodes(benchmark::State& state)
+{
+	const auto canvas = SmallFrame();
+	const auto iv = canvas.view();
+	const auto opts = ReaderOptions().formats(BarcodeFormat::QRCode);
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(ReadBarcodes(iv, opts));
+}
+BENCHMARK(BM_ReadBarcodes);
+
+static void BM_ReaderContext(benchmark::State& state)
+{
+	const auto canvas = SmallFrame();
+	const auto iv = canvas.view();
+	ReaderContext context(ReaderOptions().formats(BarcodeFormat::QRCode));
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(context.read(iv));
+}
+BENCHMARK(BM_ReaderContext);
+
+// A 1280x720 Lum video frame with a QR code moving by a few pixels per frame
+static void BM_VideoFrames(benchmark::State& state)
+{
+	const int numFrames = 8;
+	auto bits = QRCode::Writer().setMargin(0).encode(L"BarcodeTracker", 150, 150);
+	std::vector<Canvas> frames(numFrames, Canvas(1280, 720));
+	for (int i = 0; i < numFrames; ++i)
+		frames[i].draw(bits, 500 + 3 * i, 300 + 2 * i);
+
+	const auto opts = ReaderOptions().formats(BarcodeFormat::QRCode);
+	BarcodeTracker tracker(opts);
+
+	int i = 0;
+	for (auto _ : state) {
+		const auto iv = frames[i++ % numFrames].view();
+		benchmark::DoNotOptimize(state.range(0) ? tracker.read(iv) : ReadBarcodes(iv, opts));
+	}
+}
+BENCHMARK(BM_VideoFrames)->ArgName("tracker")->Arg(0)->Arg(1);
+
+// A 640x480 Lum image without a barcode but with lots of short bars and spaces, which all linear readers with
+// tryHarder need to scan in every row and both directions
+static void BM_LinearScan(benchmark::State& state)
+{
+	Canvas canvas(640, 480);
+	std::minstd_rand rand(42);
+	for (int y = 0; y < canvas.height; y += 4) {
+		bool black = false;
+		for (int x = 0, w = 0; x < canvas.width; x += w, black = !black) {
+			w = std::min<int>(1 + rand() % 8, canvas.width - x);
+			if (black)
+				canvas.fill(x, y, w, 4);
+		}
+	}
+	const auto iv = canvas.view();
+	ReaderContext context(ReaderOptions().formats(BarcodeFormat::AllLinear).tryRotate(false).tryInvert(false));
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(context.read(iv));
+}
+BENCHMARK(BM_LinearScan);
+
+// Decode a single row of a long logistics label symbol, dominated by the lookup of the individual characters
+template <typename Reader, typename Writer>
+static void BM_DecodeRow(benchmark::State& state)
+{
+	auto bits = Writer().setMargin(20).encode(L"SHIP 0123456789 ABCDEFGHIJ 9876543210", 3000, 1);
+	PatternRow row;
+	GetPatternRow(bits.row(0), row);
+	const ReaderOptions opts;
+	const Reader reader(opts);
+	std::unique_ptr<OneD::RowReader::DecodingState> decodingState;
+
+	for (auto _ : state) {
+		PatternView view(row);
+		benchmark::DoNotOptimize(reader.decodePattern(0, view, decodingState));
+	}
+}
+BENCHMARK(BM_DecodeRow<OneD::Code128Reader, OneD::Code128Writer>);
+BENCHMARK(BM_DecodeRow<OneD::Code93Reader, OneD::Code93Writer>);
+BENCHMARK(BM_DecodeRow<OneD::Code39Reader, OneD::Code39Writer>);
+
+// A 1920x1080 Lum retail shelf: 3 rows of price labels with small EAN/UPC symbols between lots of printed text
+// like clutter, i.e. many rows with hundreds of candidates for the 1:1:1 guard pattern
+static Canvas RetailShelf()
+{
+	Canvas res(1920, 1080);
+	std::minstd_rand rand(42);
+	for (int shelf = 0; shelf < 3; ++shelf) {
+		int top = 60 + shelf * 360;
+		// 'text' in 8 lines of characters with 1 to 3 pixel wide strokes
+		for (int y = top; y < top + 120; y += 15)
+			for (int x = 0; x < res.width; x += 1 + rand() % 3)
+				if (rand() % 2)
+					res.fill(x, y, 1, 10);
+		for (int i = 0; i < 6; ++i) {
+			auto bits = i % 3 == 0 ? OneD::EAN8Writer().setMargin(0).encode(L"9638507", 150, 80)
+						: i % 3 == 1 ? OneD::UPCEWriter().setMargin(0).encode(L"0123456", 150, 80)
+									 : OneD::EAN13Writer().setMargin(0).encode(std::to_wstring(400638133390 + shelf * 6 + i), 220, 80);
+			res.draw(bits, 40 + i * 310, top + 160);
+		}
+	}
+	return res;
+}
+
+static void BM_RetailShelf(benchmark::State& state)
+{
+	const auto canvas = RetailShelf();
+	const auto iv = canvas.view();
+	ReaderContext context(ReaderOptions().formats(BarcodeFormat::EANUPC).tryRotate(false).tryInvert(false));
+
+	Barcodes res;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(res = context.read(iv));
+
+	state.counters["symbols"] = Size(res);
+}
+BENCHMARK(BM_RetailShelf);
+
+// Only the MultiUPCEANReader part of BM_RetailShelf: all rows in both directions, like OneD::Reader with tryHarder
+static void BM_RetailShelfRows(benchmark::State& state)
+{
+	const auto canvas = RetailShelf();
+	const int width = canvas.width;
+	std::vector<PatternRow> rows;
+	for (int y = 0; y < canvas.height; ++y) {
+		std::vector<uint8_t> bits(width);
+		std::transform(&canvas.buf[y * width], &canvas.buf[(y + 1) * width], bits.begin(), [](uint8_t v) { return v < 128; });
+		GetPatternRow(Range<const uint8_t*>(bits.data(), bits.data() + width), rows.emplace_back());
+		rows.emplace_back(rows.back().rbegin(), rows.back().rend());
+	}
+	const auto opts = ReaderOptions().formats(BarcodeFormat::EANUPC);
+	const OneD::MultiUPCEANReader reader(opts);
+	std::unique_ptr<OneD::RowReader::DecodingState> decodingState;
+
+	int lines = 0;
+	for (auto _ : state) {
+		lines = 0;
+		for (auto& row : rows) {
+			PatternView next(row);
+			do {
+				lines += reader.decodePattern(0, next, decodingState).isValid();
+				next.shift(2 - (next.index() % 2));
+				next.extend();
+			} while (next.size());
+		}
+	}
+
+	state.counters["lines"] = lines;
+}
+BENCHMARK(BM_RetailShelfRows);
+
+// A 1920x1080 Lum frame with vertical runs only, which the 1D readers scan column by column when rotating
+static void BM_RotatedLinearScan(benchmark::State& state)
+{
+	Canvas canvas(1920, 1080);
+	std::minstd_rand rand(42);
+	for (int x = 0; x < canvas.width; x += 4) {
+		bool black = false;
+		for (int y = 0, h = 0; y < canvas.height; y += h, black = !black) {
+			h = std::min<int>(1 + rand() % 8, canvas.height - y);
+			if (black)
+				canvas.fill(x, y, 4, h);
+		}
+	}
+	const auto iv = canvas.view();
+	ReaderContext context(
+		ReaderOptions().formats(BarcodeFormat::EAN13).tryRotate(state.range(0)).tryInvert(false).tryDownscale(false));
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(context.read(iv));
+}
+BENCHMARK(BM_RotatedLinearScan)->ArgName("rotate")->Arg(0)->Arg(1);
+
+// A 2000x1500 Lum shipping label with 3 small linear symbols on a mostly blank background, scanned with RowScan range(0)
+static void BM_SparseLabel(benchmark::State& state)
+{
+	Canvas canvas(2000, 1500);
+	canvas.draw(OneD::Code128Writer().setMargin(0).encode(L"1Z999AA10123456784", 500, 80), 100, 150);
+	canvas.draw(OneD::Code128Writer().setMargin(0).encode(L"420123456789", 400, 60), 1300, 700);
+	canvas.draw(OneD::Code128Writer().setMargin(0).encode(L"SHIP-TO-0815", 450, 70), 600, 1300);
+	const auto iv = canvas.view();
+	ReaderContext context(ReaderOptions().formats(BarcodeFormat::AllLinear).rowScan(static_cast<RowScan>(state.range(0))));
+
+	Barcodes res;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(res = context.read(iv));
+
+	state.counters["symbols"] = Size(res);
+}
+BENCHMARK(BM_SparseLabel)->ArgName("rowScan")->Arg(0)->Arg(1);
+
+// A 1000x3000 Lum pallet label with 4 linear symbols, scanned in row bands by range(0) threads
+static void BM_RowBands(benchmark::State& state)
+{
+	Canvas canvas(1000, 3000);
+	canvas.draw(OneD::Code128Writer().setMargin(0).encode(L"00340123450000000018", 700, 200), 150, 200);
+	canvas.draw(OneD::Code128Writer().setMargin(0).encode(L"4012345000009", 500, 150), 250, 1000);
+	canvas.draw(OneD::Code128Writer().setMargin(0).encode(L"PALLET-0042", 450, 150), 100, 1900);
+	canvas.draw(OneD::Code128Writer().setMargin(0).encode(L"LOT-7", 300, 120), 550, 2600);
+	const auto iv = canvas.view();
+	ReaderContext context(ReaderOptions().formats(BarcodeFormat::AllLinear).tryRotate(false).maxThreads(state.range(0)));
+
+	Barcodes res;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(res = context.read(iv));
+
+	state.counters["symbols"] = Size(res);
+}
+BENCHMARK(BM_RowBands)->ArgName("threads")->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+// A 1200x900 Lum document page with lines of pseudo text, 2 QR codes and a noise texture next to a single Code 128
+// symbol, read with all linear formats. Like the falsepositives sample sets, most rows contain no linear symbol.
+static void BM_FalsePositives(benchmark::State& state)
+{
+	Canvas canvas(1200, 900);
+	const int width = canvas.width;
+
+	// glyphs of 3 px wide vertical and horizontal strokes in 12x18 cells, words separated by 15 px
+	std::mt19937 rng(42);
+	for (int top = 40; top + 18 < 560; top += 30)
+		for (int left = 40; left + 12 * 8 < width - 40;) {
+			for (int glyph = 0, len = 2 + rng() % 7; glyph < len && left + 12 < width - 40; ++glyph, left += 14) {
+				for (int x : {0, 4, 8})
+					if (rng() % 2)
+						canvas.fill(left + x, top + (x == 4 ? 6 : 0), 3, x == 4 ? 12 : 18);
+				for (int y : {0, 8, 15})
+					if (rng() % 3 == 0)
+						canvas.fill(left, top + y, 11, 3);
+			}
+			left += 15;
+		}
+	// 2x2 and 4x4 pixel noise blocks
+	for (int y = 600; y < 860; y += 2)
+		for (int x = 40; x < 400; x += (y < 730 ? 2 : 4))
+			if (rng() % 2)
+				canvas.fill(x, y, y < 730 ? 2 : 4, y < 730 ? 2 : 4);
+	canvas.draw(QRCode::Writer().setMargin(0).encode(L"https://example.com/", 200, 200), 450, 620);
+	canvas.draw(QRCode::Writer().setMargin(0).encode(L"INVOICE 2026-0815", 200, 200), 700, 620);
+	canvas.draw(OneD::Code128Writer().setMargin(0).encode(L"INV-2026-0815", 240, 60), 930, 760);
+	const auto iv = canvas.view();
+	ReaderContext context(ReaderOptions().formats(BarcodeFormat::AllLinear));
+
+	Barcodes res;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(res = context.read(iv));
+
+	state.counters["symbols"] = Size(res);
+}
+BENCHMARK(BM_FalsePositives);
+
+// A 1200x1200 Lum sheet with a grid of n small version 1 QR codes (3 px per module) in 80x80 cells
+static Canvas QRSheet(int n)
+{
+	const int cell = 80;
+	Canvas res(1200, 1200);
+	for (int i = 0; i < n; ++i) {
+		auto bits = QRCode::Writer().setMargin(0).encode(L"LOT " + std::to_wstring(1000 + i), 63, 63);
+		res.draw(bits, 8 + (i % (res.width / cell)) * cell, 8 + (i / (res.width / cell)) * cell);
+	}
+	return res;
+}
+
+// The QR sheet read with the QR code format only. The detection cost should grow linearly with the number of symbols.
+static void BM_QRSymbolCount(benchmark::State& state)
+{
+	const auto canvas = QRSheet(state.range(0));
+	const auto iv = canvas.view();
+	ReaderContext context(ReaderOptions().formats(BarcodeFormat::QRCode));
+
+	Barcodes res;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(res = context.read(iv));
+
+	state.counters["symbols"] = Size(res);
+}
+BENCHMARK(BM_QRSymbolCount)->ArgName("symbols")->Arg(1)->Arg(10)->Arg(50)->Arg(200);
+
+// A single QR code on a noisy texture of random dots, scattered with range(0) finder pattern like rings, e.g. the print of
+// a decorative background. The rings do not form any symbol, but each one is a finder pattern candidate, so the detection
+// cost should grow only moderately with their number.
+static void BM_QRNoisyTexture(benchmark::State& state)
+{
+	Canvas canvas(1200, 1200);
+	std::minstd_rand rand(42);
+	for (auto& v : canvas.buf)
+		v = rand() % 3 ? 0xff : 0;
+	for (int i = 0; i < state.range(0); ++i) {
+		// 7 modules of 1:1:3:1:1 plus a module of quiet zone on each side
+		int module = 2 + rand() % 3, left = rand() % (canvas.width - 9 * module), top = rand() % (canvas.height - 9 * module);
+		for (int ring = 4; ring > 0; --ring)
+			canvas.fill(left + (4 - ring) * module, top + (4 - ring) * module, (2 * ring + 1) * module,
+						(2 * ring + 1) * module, ring == 2 || ring == 4 ? 0xff : 0);
+	}
+	auto bits = QRCode::Writer().setMargin(4).encode(L"texture", 200, 200);
+	canvas.fill(500, 500, bits.width(), bits.height(), 0xff);
+	canvas.draw(bits, 500, 500);
+
+	const auto iv = canvas.view();
+	ReaderContext context(ReaderOptions().formats(BarcodeFormat::QRCode));
+
+	Barcodes res;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(res = context.read(iv));
+
+	state.counters["symbols"] = Size(res);
+}
+BENCHMARK(BM_QRNoisyTexture)->ArgName("rings")->Arg(0)->Arg(100)->Arg(300);
+
+// The QR sheet with 100 symbols in a single pass (no inverted or downscaled variants), its candidates sampled and decoded by
+// range(0) threads
+static void BM_QRCandidates(benchmark::State& state)
+{
+	const auto canvas = QRSheet(100);
+	const auto iv = canvas.view();
+	ReaderContext context(
+		ReaderOptions().formats(BarcodeFormat::QRCode).tryInvert(false).tryDownscale(false).maxThreads(state.range(0)));
+
+	Barcodes res;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(res = context.read(iv));
+
+	state.counters["symbols"] = Size(res);
+}
+BENCHMARK(BM_QRCandidates)->ArgName("threads")->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+// Decode an already sampled QR code of version range(0): read the format and version information, unmask and extract the
+// codewords, correct errors and parse them
+static void BM_QRDecode(benchmark::State& state)
+{
+	const int dimension = 17 + 4 * state.range(0);
+	auto bits = QRCode::Writer().setMargin(0).setVersion(state.range(0)).encode(std::wstring(dimension, L'A'), dimension, dimension);
+
+	DecoderResult res;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(res = QRCode::Decode(bits));
+
+	state.counters["valid"] = res.isValid();
+}
+BENCHMARK(BM_QRDecode)->ArgName("version")->Arg(2)->Arg(10)->Arg(40);
+
+// A single well printed QR code of version range(0) at 3 pixels per module, where the global perspective transform
+// is sufficient and the alignment patterns don't need to be located.
+static void BM_QRSample(benchmark::State& state)
+{
+	const int dimension = 17 + 4 * state.range(0), scale = 3, width = (dimension + 8) * scale;
+	auto bits = QRCode::Writer().setMargin(4).setVersion(state.range(0)).encode(std::wstring(dimension, L'A'), width, width);
+	Canvas canvas(width, width);
+	canvas.draw(bits, 0, 0);
+	const auto iv = canvas.view();
+	ReaderContext context(ReaderOptions().formats(BarcodeFormat::QRCode));
+
+	Barcodes res;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(res = context.read(iv));
+
+	state.counters["symbols"] = Size(res);
+}
+BENCHMARK(BM_QRSample)->ArgName("version")->Arg(10)->Arg(25)->Arg(40);
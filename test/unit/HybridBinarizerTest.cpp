@@ -0,0 +1,144 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BitMatrix.h"
+#include "HybridBinarizer.h"
+#include "PseudoRandom.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace ZXing;
+
+static std::vector<uint8_t> RandomImage(int width, int height, int seed)
+{
+	PseudoRandom rand(seed);
+	std::vector<uint8_t> res(width * height);
+	// low contrast noise with some high contrast blocks so that both branches of the threshold formula are used
+	for (int y = 0; y < height; ++y)
+		for (int x = 0; x < width; ++x)
+			res[y * width + x] = static_cast<uint8_t>(((x / 8 + y / 8) % 3 ? 100 : rand.next(0, 150)) + rand.next(0, 20));
+	return res;
+}
+
+TEST(HybridBinarizerTest, BlockThresholdsBuilder)
+{
+	for (auto [w, h] : {std::pair{8, 8}, {13, 9}, {40, 40}, {45, 61}, {100, 50}}) {
+		auto img = RandomImage(w, h, w * h);
+
+		BlockThresholdsBuilder builder(w, h);
+		for (int y = 0; y < h; ++y)
+			builder.addRow(y, img.data() + y * w);
+		auto thresholds = builder.thresholds();
+
+		ASSERT_EQ(thresholds.width(), (w + 7) / 8);
+		ASSERT_EQ(thresholds.height(), (h + 7) / 8);
+		for (int by = 0; by < thresholds.height(); ++by)
+			for (int bx = 0; bx < thresholds.width(); ++bx) {
+				int x0 = std::min(bx * 8, w - 8), y0 = std::min(by * 8, h - 8);
+				int min = 255, max = 0;
+				for (int y = y0; y < y0 + 8; ++y)
+					for (int x = x0; x < x0 + 8; ++x) {
+						min = std::min<int>(min, img[y * w + x]);
+						max = std::max<int>(max, img[y * w + x]);
+					}
+				EXPECT_EQ(thresholds(bx, by), max - min > 24 ? (max + min) / 2 : 0) << bx << ", " << by;
+			}
+	}
+
+	EXPECT_EQ(BlockThresholdsBuilder(7, 100).thresholds().size(), 0);
+}
+
+TEST(HybridBinarizerTest, PrecomputedBlockThresholds)
+{
+	const int w = 123, h = 77;
+	auto img = RandomImage(w, h, 1);
+	ImageView iv(img.data(), w, h, ImageFormat::Lum);
+
+	BlockThresholdsBuilder builder(w, h);
+	for (int y = 0; y < h; ++y)
+		builder.addRow(y, iv.data(0, y));
+
+	EXPECT_EQ(*HybridBinarizer(iv, builder.thresholds()).getBitMatrix(), *HybridBinarizer(iv).getBitMatrix());
+}
+
+TEST(HybridBinarizerTest, PixStride)
+{
+	for (auto [w, h] : {std::pair{40, 40}, {123, 77}, {200, 41}}) {
+		auto img = RandomImage(w, h, w + h);
+		auto dense = HybridBinarizer(ImageView(img.data(), w, h, ImageFormat::Lum)).getBitMatrix();
+
+		for (int pixStride : {2, 3}) {
+			// the luminance is the second byte of each pixel, like the Y in UYVY
+			std::vector<uint8_t> buf(w * h * pixStride, 0x80);
+			for (int i = 0; i < w * h; ++i)
+				buf[i * pixStride + 1] = img[i];
+			ImageView iv(buf.data() + 1, w, h, ImageFormat::Lum, w * pixStride, pixStride);
+
+			EXPECT_EQ(*HybridBinarizer(iv).getBitMatrix(), *dense) << w << "x" << h << ", " << pixStride;
+		}
+	}
+}
+
+TEST(HybridBinarizerTest, MatrixPool)
+{
+	const int w = 123, h = 77;
+	auto img = RandomImage(w, h, 2);
+	ImageView iv(img.data(), w, h, ImageFormat::Lum);
+	auto expected = HybridBinarizer(iv).getBitMatrix()->copy();
+
+	BitMatrixPool pool;
+	const BitMatrix* first = nullptr;
+	for (int i = 0; i < 3; ++i) {
+		HybridBinarizer bin(iv);
+		bin.setMatrixPool(&pool);
+		auto* bits = bin.getBitMatrix();
+		EXPECT_EQ(*bits, expected);
+		// the matrix of the destroyed binarizer gets reused
+		if (!first)
+			first = bits;
+		EXPECT_EQ(bits, first);
+
+		// one that is still in use does not
+		HybridBinarizer other(ImageView(img.data(), w - 10, h, ImageFormat::Lum, w));
+		other.setMatrixPool(&pool);
+		EXPECT_NE(other.getBitMatrix(), bits);
+		EXPECT_EQ(other.getBitMatrix()->width(), w - 10);
+	}
+}
+
+TEST(HybridBinarizerTest, ColumnPatternRows)
+{
+	// the columns of a rotated scan are copied in tiles, the result must match a row scan of a rotated copy
+	for (auto [w, h] : {std::pair{13, 9}, {70, 45}, {150, 83}}) {
+		auto buf = RandomImage(w, h, w);
+		for (int pixStride : {1, 2}) {
+			std::vector<uint8_t> strided(w * h * pixStride);
+			for (int i = 0; i < w * h; ++i)
+				strided[i * pixStride] = buf[i];
+			const ImageView iv(strided.data(), w, h, ImageFormat::Lum, w * pixStride, pixStride);
+			HybridBinarizer bin(iv);
+
+			for (int rotation : {90, 270, -90}) {
+				std::vector<uint8_t> rotated(w * h);
+				const auto rv = ImageView(buf.data(), w, h, ImageFormat::Lum).rotated(rotation);
+				for (int y = 0; y < w; ++y)
+					for (int x = 0; x < h; ++x)
+						rotated[y * h + x] = *rv.data(x, y);
+				HybridBinarizer ref(ImageView(rotated.data(), h, w, ImageFormat::Lum));
+
+				// visit the columns in an order that requires reloading tiles
+				for (int i = 0; i < w; ++i) {
+					int x = (i * 37) % w;
+					PatternRow res, expected;
+					EXPECT_EQ(bin.getPatternRow(x, rotation, res), ref.getPatternRow(x, 0, expected));
+					EXPECT_EQ(res, expected) << w << "x" << h << ", pixStride " << pixStride << ", rotation " << rotation;
+				}
+			}
+		}
+	}
+}
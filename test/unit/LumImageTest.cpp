@@ -0,0 +1,70 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "LumImage.h"
+#include "PseudoRandom.h"
+#include "ZXAlgorithms.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace ZXing;
+
+static std::vector<uint8_t> RandomBytes(int n, int seed)
+{
+	PseudoRandom rand(seed);
+	std::vector<uint8_t> res(n);
+	for (auto& v : res)
+		v = static_cast<uint8_t>(rand.next(0, 255));
+	return res;
+}
+
+static void CheckLum(const ImageView& iv, const LumImage& lum)
+{
+	ASSERT_EQ(lum.width(), iv.width());
+	ASSERT_EQ(lum.height(), iv.height());
+	ASSERT_EQ(lum.rowStride(), iv.width());
+	const int r = RedIndex(iv.format()), g = GreenIndex(iv.format()), b = BlueIndex(iv.format());
+	for (int y = 0; y < iv.height(); ++y)
+		for (int x = 0; x < iv.width(); ++x) {
+			auto* p = iv.data(x, y);
+			ASSERT_EQ(*lum.data(x, y), RGBToLum(p[r], p[g], p[b])) << x << ", " << y;
+		}
+}
+
+TEST(LumImageTest, RGBFormats)
+{
+	using enum ImageFormat;
+	for (auto format : {RGB, BGR, RGBA, ARGB, BGRA, ABGR})
+		// cover the widths around the 16 and 32 pixel SIMD block sizes
+		for (int width : {1, 15, 16, 17, 31, 33, 34, 35, 36, 64, 100, 257}) {
+			const int height = 3, padding = 5;
+			const int rowStride = width * PixStride(format) + padding;
+			auto buf = RandomBytes(rowStride * height, width);
+			ImageView iv(buf.data(), Size(buf), width, height, format, rowStride);
+
+			CheckLum(iv, ExtractLum(iv));
+			CheckLum(iv.rotated(90), ExtractLum(iv.rotated(90)));
+			CheckLum(iv.rotated(180), ExtractLum(iv.rotated(180)));
+		}
+}
+
+TEST(LumImageTest, LumFormats)
+{
+	const int width = 37, height = 4;
+	auto buf = RandomBytes(width * height * 2, 1);
+
+	for (auto format : {ImageFormat::LumA, ImageFormat::YUYV, ImageFormat::UYVY}) {
+		ImageView iv(buf.data(), Size(buf), width, height, format);
+		auto lum = ExtractLum(iv);
+		for (int y = 0; y < height; ++y)
+			for (int x = 0; x < width; ++x)
+				EXPECT_EQ(*lum.data(x, y), buf[y * width * 2 + x * 2 + (format == ImageFormat::UYVY)]);
+	}
+
+	ImageView iv(buf.data(), width, height, ImageFormat::Lum, 0, 2);
+	CheckLum(iv, ExtractLum(iv));
+}
@@ -0,0 +1,96 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BitMatrix.h"
+#include "PackedBitMatrix.h"
+#include "PseudoRandom.h"
+
+#include "gtest/gtest.h"
+
+using namespace ZXing;
+
+static BitMatrix RandomBitMatrix(int width, int height, int seed)
+{
+	PseudoRandom rand(seed);
+	BitMatrix res(width, height);
+	// runs of random length to get something resembling real bar/space patterns
+	bool val = false;
+	for (int y = 0; y < height; ++y)
+		for (int x = 0; x < width; ++x) {
+			if (rand.next(0, 4) == 0)
+				val = !val;
+			res.set(x, y, val);
+		}
+	return res;
+}
+
+TEST(PackedBitMatrixTest, RoundTrip)
+{
+	for (auto [w, h] : {std::pair{1, 1}, {63, 5}, {64, 3}, {65, 7}, {200, 130}}) {
+		auto bits = RandomBitMatrix(w, h, w * h);
+		PackedBitMatrix packed(bits);
+		EXPECT_EQ(packed.width(), w);
+		EXPECT_EQ(packed.height(), h);
+		for (int y = 0; y < h; ++y)
+			for (int x = 0; x < w; ++x)
+				EXPECT_EQ(packed.get(x, y), bits.get(x, y));
+		EXPECT_EQ(packed.toBitMatrix(), bits);
+	}
+}
+
+TEST(PackedBitMatrixTest, FlipAll)
+{
+	auto bits = RandomBitMatrix(70, 9, 1);
+	PackedBitMatrix packed(bits);
+	packed.flipAll();
+	bits.flipAll();
+	EXPECT_EQ(packed.toBitMatrix(), bits);
+	EXPECT_EQ(packed, PackedBitMatrix(bits)); // bits beyond width stay 0
+}
+
+TEST(PackedBitMatrixTest, Transpose)
+{
+	for (auto [w, h] : {std::pair{1, 1}, {3, 70}, {64, 64}, {100, 130}, {130, 65}}) {
+		auto bits = RandomBitMatrix(w, h, w + h);
+		auto transposed = PackedBitMatrix(bits).transposed();
+		ASSERT_EQ(transposed.width(), h);
+		ASSERT_EQ(transposed.height(), w);
+		for (int y = 0; y < h; ++y)
+			for (int x = 0; x < w; ++x)
+				EXPECT_EQ(transposed.get(y, x), bits.get(x, y));
+	}
+}
+
+TEST(PackedBitMatrixTest, Rotate90)
+{
+	auto bits = RandomBitMatrix(77, 41, 2);
+	auto rotated = bits.copy();
+	rotated.rotate90();
+	ASSERT_EQ(rotated.width(), bits.height());
+	ASSERT_EQ(rotated.height(), bits.width());
+	for (int y = 0; y < bits.height(); ++y)
+		for (int x = 0; x < bits.width(); ++x)
+			EXPECT_EQ(rotated.get(y, bits.width() - x - 1), bits.get(x, y));
+}
+
+TEST(PackedBitMatrixTest, DilateErode)
+{
+	auto bits = RandomBitMatrix(131, 17, 3);
+	auto dilated = PackedBitMatrix(bits).dilated();
+	auto eroded = PackedBitMatrix(bits).eroded();
+
+	for (int y = 0; y < bits.height(); ++y)
+		for (int x = 0; x < bits.width(); ++x) {
+			bool any = false, all = true;
+			for (int dy = -1; dy <= 1; ++dy)
+				for (int dx = -1; dx <= 1; ++dx)
+					if (bits.isIn(PointI(x + dx, y + dy))) {
+						any |= bits.get(x + dx, y + dy);
+						all &= bits.get(x + dx, y + dy);
+					}
+			EXPECT_EQ(dilated.get(x, y), any) << x << ", " << y;
+			EXPECT_EQ(eroded.get(x, y), all) << x << ", " << y;
+		}
+}
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "Pattern.h"
+#include "PseudoRandom.h"
 
 #include "gtest/gtest.h"
 
@@ -64,3 +65,56 @@ TEST(PatternTest, WhiteBlack)
 		EXPECT_EQ(pr[2], 0);
 	}
 }
+
+TEST(PatternTest, RandomRuns)
+{
+	// the SIMD code path for contiguous bytes must match the one pixel at a time loop used for strided input
+	PseudoRandom rand(42);
+	PatternRow expected;
+	for (int s = 1; s <= 300; ++s) {
+		for (int maxRun : {1, 3, 40, 400}) {
+			std::vector<uint8_t> in(s);
+			uint8_t v = rand.next(0, 1) * 0xff;
+			for (int x = 0; x < s; v = ~v)
+				for (int n = rand.next(1, maxRun); n && x < s; --n)
+					in[x++] = v;
+
+			GetPatternRow(Range{in}, pr);
+			GetPatternRow(Range<StrideIter<const uint8_t*>>{{in.data(), 1}, {in.data() + s, 1}}, expected);
+
+			ASSERT_EQ(pr, expected) << "size " << s << ", maxRun " << maxRun;
+			ASSERT_EQ(Reduce(pr), s);
+		}
+	}
+}
+
+TEST(PatternTest, GuardIndex)
+{
+	// FindLeftGuard must return the same windows with and without the index
+	PseudoRandom rand(42);
+	PatternRow bars(201);
+	GuardIndex guards;
+	for (int n = 0; n < 100; ++n) {
+		for (auto& b : bars)
+			b = rand.next(1, rand.next(0, 9) ? 6 : 30);
+		guards.build(bars);
+
+		auto check = [&](const auto& pattern, double minQuietZone) {
+			PatternView a(bars), b(bars, &guards);
+			for (int i = 0; i < 200 && a.size(); ++i) {
+				a = FindLeftGuard(a, 10, pattern, minQuietZone);
+				b = FindLeftGuard(b, 10, pattern, minQuietZone);
+				ASSERT_EQ(a.data(), b.data());
+				if (!a.isValid())
+					break;
+				a.shift(1 + i % 2), b.shift(1 + i % 2);
+				a.extend(), b.extend();
+			}
+		};
+		for (double qz : {2.5, 3.0, 4.0, 5.0, 6.0, 7.0})
+			check(FixedPattern<3, 3>{1, 1, 1}, qz);
+		for (double qz : {2.0, 5.0, 6.0})
+			check(FixedPattern<4, 4>{1, 1, 1, 1}, qz);
+		check(FixedPattern<3, 4>{2, 1, 1}, 5.0);
+	}
+}
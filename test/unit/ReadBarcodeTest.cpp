@@ -0,0 +1,471 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BarcodeTracker.h"
+#include "BitMatrix.h"
+#include "ReadBarcode.h"
+#include "ReaderContext.h"
+#include "ThreadPool.h"
+#include "oned/ODCode128Writer.h"
+#include "oned/ODCode39Writer.h"
+#include "oned/ODEAN13Writer.h"
+#include "oned/ODITFWriter.h"
+#include "qrcode/QRWriter.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
+
+using namespace ZXing;
+
+namespace {
+
+// Simple Lum canvas that multiple symbols can be drawn onto
+struct Canvas
+{
+	int width, height;
+	std::vector<uint8_t> buf;
+
+	Canvas(int w, int h) : width(w), height(h), buf(w * h, 0xff) {}
+
+	void draw(const BitMatrix& bits, int left, int top)
+	{
+		for (int y = 0; y < bits.height(); ++y)
+			for (int x = 0; x < bits.width(); ++x)
+				if (bits.get(x, y))
+					buf[(top + y) * width + left + x] = 0;
+	}
+
+	ImageView view() const { return {buf.data(), width, height, ImageFormat::Lum}; }
+};
+
+// Executor that counts the tasks it forwards to another one
+struct CountingExecutor : Executor
+{
+	Executor& executor;
+	std::atomic<int> posts = 0;
+
+	explicit CountingExecutor(Executor& e) : executor(e) {}
+
+	int concurrency() const override { return executor.concurrency(); }
+	void post(std::function<void()> task) override
+	{
+		++posts;
+		executor.post(std::move(task));
+	}
+};
+
+std::vector<std::string> Texts(const Barcodes& barcodes)
+{
+	std::vector<std::string> res;
+	for (auto& b : barcodes)
+		res.push_back(b.text());
+	return res;
+}
+
+} // namespace
+
+TEST(ReadBarcodeTest, MaxThreads)
+{
+	Canvas canvas(1200, 900);
+	canvas.draw(QRCode::Writer().setMargin(0).encode(L"first", 150, 150), 50, 50);
+	canvas.draw(QRCode::Writer().setMargin(0).encode(L"second", 300, 300), 600, 100);
+	canvas.draw(QRCode::Writer().setMargin(0).encode(L"third", 200, 200), 300, 600);
+	canvas.draw(OneD::Code128Writer().setMargin(0).encode(L"fourth", 400, 80), 700, 700);
+
+	auto opts = ReaderOptions().formats(BarcodeFormat::QRCode | BarcodeFormat::Code128).downscaleThreshold(300);
+	auto serial = ReadBarcodes(canvas.view(), opts);
+	ASSERT_EQ(Size(serial), 4);
+
+	for (int threads : {0, 2, 4}) {
+		auto parallel = ReadBarcodes(canvas.view(), ReaderOptions(opts).maxThreads(threads));
+		EXPECT_EQ(Texts(parallel), Texts(serial));
+		for (int i = 0; i < Size(serial); ++i)
+			EXPECT_EQ(parallel[i].position(), serial[i].position());
+	}
+
+	for (int maxSymbols : {1, 2, 3}) {
+		auto opts2 = ReaderOptions(opts).maxNumberOfSymbols(maxSymbols);
+		auto res1 = ReadBarcodes(canvas.view(), opts2);
+		auto res4 = ReadBarcodes(canvas.view(), ReaderOptions(opts2).maxThreads(4));
+		EXPECT_EQ(Size(res4), maxSymbols);
+		EXPECT_EQ(Texts(res4), Texts(res1));
+	}
+}
+
+TEST(ReadBarcodeTest, ParallelQRCandidates)
+{
+	Canvas canvas(800, 640);
+	for (int i = 0; i < 40; ++i)
+		canvas.draw(QRCode::Writer().setMargin(0).encode(L"QR " + std::to_wstring(i), 63, 63), 8 + i % 10 * 80, 8 + i / 10 * 80);
+
+	// a single pass, so only the candidates are processed concurrently
+	ThreadPool pool(3);
+	auto opts = ReaderOptions().formats(BarcodeFormat::QRCode).tryInvert(false).tryDownscale(false).executor(&pool);
+	auto serial = ReadBarcodes(canvas.view(), opts);
+	ASSERT_EQ(Size(serial), 40);
+
+	for (int threads : {2, 4}) {
+		auto parallel = ReadBarcodes(canvas.view(), ReaderOptions(opts).maxThreads(threads));
+		EXPECT_EQ(Texts(parallel), Texts(serial));
+		for (int i = 0; i < std::min(Size(parallel), Size(serial)); ++i)
+			EXPECT_EQ(parallel[i].position(), serial[i].position());
+	}
+
+	for (int maxSymbols : {1, 7}) {
+		auto opts2 = ReaderOptions(opts).maxNumberOfSymbols(maxSymbols);
+		EXPECT_EQ(Texts(ReadBarcodes(canvas.view(), ReaderOptions(opts2).maxThreads(4))), Texts(ReadBarcodes(canvas.view(), opts2)));
+	}
+}
+
+TEST(ReadBarcodeTest, ProgressiveQRSampling)
+{
+	// a version 10 symbol at 3 pixels per module, decodable with the global perspective transform alone
+	Canvas canvas(250, 250);
+	canvas.draw(QRCode::Writer().setMargin(0).setVersion(10).encode(L"progressive", 171, 171), 40, 40);
+	auto opts = ReaderOptions().formats(BarcodeFormat::QRCode).returnErrors(true);
+	EXPECT_EQ(Texts(ReadBarcodes(canvas.view(), opts)), std::vector<std::string>{"progressive"});
+
+	// destroy the data in two areas beside the central alignment pattern: both the global and the tiled sample fail,
+	// which has to be reported as one symbol only
+	for (int y = 32 * 3; y < 48 * 3; ++y)
+		for (int x : {8, 32})
+			for (int i = 0; i < 16 * 3; ++i)
+				canvas.buf[(40 + y) * canvas.width + 40 + x * 3 + i] ^= 0xff;
+	auto res = ReadBarcodes(canvas.view(), opts);
+	auto qr = std::find_if(res.begin(), res.end(), [](auto& b) { return b.format() == BarcodeFormat::QRCode; });
+	ASSERT_NE(qr, res.end());
+	EXPECT_FALSE(qr->isValid());
+	EXPECT_EQ(std::count_if(res.begin(), res.end(), [](auto& b) { return b.format() == BarcodeFormat::QRCode; }), 1);
+}
+
+TEST(ReadBarcodeTest, YUVFormats)
+{
+	Canvas canvas(300, 200);
+	canvas.draw(QRCode::Writer().setMargin(0).encode(L"yuv", 120, 120), 90, 40);
+	const int w = canvas.width, h = canvas.height;
+
+	// NV12 frame: the Y plane followed by a half resolution plane of interleaved chroma samples
+	std::vector<uint8_t> nv12(canvas.buf);
+	nv12.resize(w * h * 3 / 2, 0x80);
+	auto res = ReadBarcodes({nv12.data(), Size(nv12), w, h, ImageFormat::NV12}, {});
+	EXPECT_EQ(Texts(res), std::vector<std::string>{"yuv"});
+
+	// UYVY frame: every Y sample is preceded by a U or V sample
+	std::vector<uint8_t> uyvy(w * h * 2, 0x80);
+	for (int i = 0; i < w * h; ++i)
+		uyvy[2 * i + 1] = canvas.buf[i];
+	for (auto binarizer : {Binarizer::LocalAverage, Binarizer::GlobalHistogram, Binarizer::FixedThreshold}) {
+		res = ReadBarcodes({uyvy.data(), Size(uyvy), w, h, ImageFormat::UYVY}, ReaderOptions().binarizer(binarizer));
+		EXPECT_EQ(Texts(res), std::vector<std::string>{"yuv"});
+	}
+}
+
+TEST(ReadBarcodeTest, ReaderContext)
+{
+	Canvas large(800, 600), small(200, 150);
+	large.draw(QRCode::Writer().setMargin(0).encode(L"large", 200, 200), 100, 100);
+	large.draw(OneD::Code128Writer().setMargin(0).encode(L"code128", 300, 60), 400, 450);
+	small.draw(QRCode::Writer().setMargin(0).encode(L"small", 100, 100), 50, 25);
+
+	for (auto opts : {ReaderOptions().downscaleThreshold(300), ReaderOptions().maxThreads(2), ReaderOptions().isPure(true),
+					  ReaderOptions().binarizer(Binarizer::GlobalHistogram)}) {
+		ReaderContext context(opts);
+		// alternate the image sizes so that the reused buffers have to grow and shrink
+		for (auto* canvas : {&large, &small, &large, &small}) {
+			auto expected = ReadBarcodes(canvas->view(), opts);
+			auto actual = context.read(canvas->view());
+			EXPECT_EQ(Texts(actual), Texts(expected));
+			for (int i = 0; i < std::min(Size(actual), Size(expected)); ++i)
+				EXPECT_EQ(actual[i].position(), expected[i].position());
+		}
+	}
+}
+
+TEST(ReadBarcodeTest, RegionsOfInterest)
+{
+	Canvas canvas(800, 600);
+	canvas.draw(QRCode::Writer().setMargin(0).encode(L"first", 150, 150), 50, 50);
+	canvas.draw(QRCode::Writer().setMargin(0).encode(L"second", 150, 150), 500, 50);
+	canvas.draw(OneD::Code128Writer().setMargin(0).encode(L"third", 300, 60), 400, 450);
+
+	auto roi = [](int left, int top, int width, int height) {
+		return Position{PointI{left, top}, {left + width - 1, top}, {left + width - 1, top + height - 1}, {left, top + height - 1}};
+	};
+
+	auto full = ReadBarcodes(canvas.view());
+	ASSERT_EQ(Size(full), 3);
+
+	// the second one lies across two overlapping regions, the third one is not in any region
+	std::vector<Position> rois = {roi(20, 20, 210, 210), roi(480, 30, 100, 190), roi(560, 30, 110, 190)};
+	for (int threads : {1, 2}) {
+		auto res = ReadBarcodes(canvas.view(), rois, ReaderOptions().maxThreads(threads));
+		EXPECT_EQ(Texts(res), (std::vector<std::string>{"first", "second"}));
+		for (int i = 0; i < Size(res); ++i)
+			EXPECT_EQ(res[i].position(), full[i].position()) << i;
+	}
+
+	// regions partially outside of the image, empty ones and the symbol limit
+	rois = {roi(-100, 350, 1000, 400), roi(900, 0, 100, 100), roi(0, 0, 400, 300)};
+	EXPECT_EQ(Texts(ReadBarcodes(canvas.view(), rois, {})), (std::vector<std::string>{"third", "first"}));
+	EXPECT_EQ(Texts(ReadBarcodes(canvas.view(), rois, ReaderOptions().maxNumberOfSymbols(1))), std::vector<std::string>{"third"});
+	EXPECT_TRUE(ReadBarcodes(canvas.view(), std::vector<Position>{}, {}).empty());
+}
+
+TEST(ReadBarcodeTest, ReadBarcodesBatch)
+{
+	std::vector<Canvas> canvases;
+	for (int i = 0; i < 7; ++i) {
+		auto& canvas = canvases.emplace_back(300 + 50 * i, 200 + 30 * i);
+		auto text = L"batch" + std::to_wstring(i);
+		if (i % 3 == 0)
+			canvas.draw(OneD::Code128Writer().setMargin(0).encode(text, 200, 50), 40, 60);
+		else if (i % 3 == 1)
+			canvas.draw(QRCode::Writer().setMargin(0).encode(text, 120, 120), 60, 40);
+		// every third image is empty
+	}
+	std::vector<ImageView> images;
+	for (auto& canvas : canvases)
+		images.push_back(canvas.view());
+
+	auto opts = ReaderOptions().formats(BarcodeFormat::QRCode | BarcodeFormat::Code128);
+	ThreadPool pool(2);
+
+	// by default all threads of the pool are used, the stacked rows of different images are not combined
+	for (int threads : {-1, 1, 2}) {
+		auto contextOpts = ReaderOptions(opts).accumulateStackedRows(true);
+		if (threads > 0)
+			contextOpts.maxThreads(threads);
+		ReaderContext context(contextOpts);
+		// the second batch reuses the buffers of the first one
+		for (int batch = 0; batch < 2; ++batch) {
+			auto res = context.read(images, pool);
+			ASSERT_EQ(Size(res), Size(images));
+			for (int i = 0; i < Size(images); ++i) {
+				EXPECT_EQ(res[i].status, BatchResult::Status::Complete);
+				EXPECT_EQ(Texts(res[i].barcodes), Texts(ReadBarcodes(images[i], opts))) << i;
+			}
+		}
+	}
+
+	// an explicit maxThreads(1) reads all images on the calling thread
+	CountingExecutor counting(pool);
+	ReaderContext(ReaderOptions(opts).maxThreads(1)).read(images, counting);
+	EXPECT_EQ(counting.posts, 0);
+	ReaderContext(opts).read(images, counting);
+	EXPECT_GT(counting.posts, 0);
+
+	CancellationToken cancel;
+	cancel.cancel();
+	for (auto& r : ReadBarcodesBatch(images, opts, pool, &cancel)) {
+		EXPECT_EQ(r.status, BatchResult::Status::Cancelled);
+		EXPECT_TRUE(r.barcodes.empty());
+	}
+
+	Canvas large(1600, 1200);
+	large.draw(QRCode::Writer().setMargin(0).encode(L"large", 300, 300), 100, 100);
+	auto res = ReadBarcodesBatch({large.view()}, ReaderOptions().tryInvert(true), pool, nullptr, std::chrono::minutes(1));
+	EXPECT_EQ(res.front().status, BatchResult::Status::Complete);
+	EXPECT_EQ(Texts(res.front().barcodes), std::vector<std::string>{"large"});
+	// the passes over the large image take longer than the time budget. Depending on the scheduling, the image is
+	// interrupted before or after the first pass, so only the status is deterministic.
+	res = ReadBarcodesBatch({large.view()}, ReaderOptions().tryInvert(true), pool, nullptr, std::chrono::milliseconds(1));
+	EXPECT_EQ(res.front().status, BatchResult::Status::TimedOut);
+	EXPECT_LE(Size(res.front().barcodes), 1);
+
+	EXPECT_TRUE(ReadBarcodesBatch({}, opts, pool).empty());
+	EXPECT_THROW(ReadBarcodesBatch({images[0], ImageView()}, opts, pool), std::invalid_argument);
+}
+
+TEST(ReadBarcodeTest, BarcodeTracker)
+{
+	auto qrCode = QRCode::Writer().setMargin(0).encode(L"qrcode", 120, 120);
+	auto code128 = OneD::Code128Writer().setMargin(0).encode(L"code128", 240, 50);
+
+	BarcodeTracker tracker({}, 5);
+	std::vector<bool> tracking;
+	for (int frame = 0; frame < 12; ++frame) {
+		// both symbols move a few pixels per frame, the Code 128 one leaves the view after frame 8
+		Canvas canvas(640, 480);
+		canvas.draw(qrCode, 50 + 4 * frame, 60 + 2 * frame);
+		if (frame <= 8)
+			canvas.draw(code128, 300 + 5 * frame, 350 - 3 * frame);
+
+		auto res = tracker.read(canvas.view());
+		auto expected = ReadBarcodes(canvas.view());
+		EXPECT_EQ(Texts(res), Texts(expected)) << frame;
+		for (int i = 0; i < std::min(Size(res), Size(expected)); ++i)
+			EXPECT_EQ(res[i].position(), expected[i].position()) << frame;
+		tracking.push_back(tracker.tracking());
+	}
+
+	// a full scan every 5th frame and after the Code 128 symbol got lost in frame 9
+	EXPECT_EQ(tracking, (std::vector<bool>{false, true, true, true, true, false, true, true, true, false, true, true}));
+}
+
+TEST(ReadBarcodeTest, BarcodeTrackerLostSymbol)
+{
+	auto qrCode = QRCode::Writer().setMargin(0).encode(L"qrcode", 120, 120);
+	auto newQRCode = QRCode::Writer().setMargin(0).encode(L"new", 80, 80);
+	auto code128 = OneD::Code128Writer().setMargin(0).encode(L"code128", 240, 50);
+
+	auto sorted = [](std::vector<std::string>&& v) { return std::ranges::sort(v), v; };
+	BarcodeTracker tracker({}, 10);
+	std::vector<bool> tracking;
+	for (int frame = 0; frame < 4; ++frame) {
+		// in frame 2 the QR Code symbol jumps out of its window, while a new one appears in the window of the Code 128
+		// symbol, i.e. the number of symbols found in the windows stays the same
+		Canvas canvas(640, 480);
+		canvas.draw(qrCode, frame < 2 ? 50 : 480, frame < 2 ? 60 : 20);
+		canvas.draw(code128, 300, 350);
+		if (frame >= 2)
+			canvas.draw(newQRCode, 320, 250);
+
+		EXPECT_EQ(sorted(Texts(tracker.read(canvas.view()))), sorted(Texts(ReadBarcodes(canvas.view())))) << frame;
+		tracking.push_back(tracker.tracking());
+	}
+
+	EXPECT_EQ(tracking, (std::vector<bool>{false, true, false, true}));
+}
+
+TEST(ReadBarcodeTest, AdaptiveRowScan)
+{
+	// a sparse label: small linear symbols far apart on a mostly blank canvas
+	Canvas canvas(1200, 900);
+	canvas.draw(OneD::Code128Writer().setMargin(0).encode(L"one", 300, 40), 50, 60);
+	canvas.draw(OneD::Code128Writer().setMargin(0).encode(L"two", 250, 30), 800, 420);
+	canvas.draw(OneD::Code128Writer().setMargin(0).encode(L"three", 300, 50), 300, 820);
+
+	auto sorted = [](std::vector<std::string>&& v) { return std::ranges::sort(v), v; };
+	const auto opts = ReaderOptions().formats(BarcodeFormat::AllLinear);
+	const auto expected = std::vector<std::string>{"one", "three", "two"};
+	EXPECT_EQ(sorted(Texts(ReadBarcodes(canvas.view(), ReaderOptions(opts).rowScan(RowScan::MiddleOut)))), expected);
+	EXPECT_EQ(sorted(Texts(ReadBarcodes(canvas.view(), ReaderOptions(opts).rowScan(RowScan::Adaptive)))), expected);
+
+	// without tryHarder the row scan is unchanged
+	EXPECT_EQ(Texts(ReadBarcodes(canvas.view(), ReaderOptions(opts).tryHarder(false).rowScan(RowScan::Adaptive))),
+			  Texts(ReadBarcodes(canvas.view(), ReaderOptions(opts).tryHarder(false))));
+}
+
+TEST(ReadBarcodeTest, LargeModules)
+{
+	// the row classifier must not depend on the scale, i.e. also accept rows where every element is wider than 30 pixels
+	auto read = [](const BitMatrix& bits, int moduleSize) {
+		const int quietZone = 10 * moduleSize;
+		Canvas canvas(bits.width() * moduleSize + 2 * quietZone, 40);
+		for (int x = 0; x < bits.width() * moduleSize; ++x)
+			if (bits.get(x / moduleSize, 0))
+				for (int y = 0; y < canvas.height; ++y)
+					canvas.buf[y * canvas.width + quietZone + x] = 0;
+		return Texts(ReadBarcodes(canvas.view(), ReaderOptions().formats(BarcodeFormat::AllLinear).tryDownscale(false)));
+	};
+
+	for (int moduleSize : {8, 31, 40}) {
+		EXPECT_EQ(read(OneD::EAN13Writer().setMargin(0).encode(L"4006381333931", 1, 1), moduleSize),
+				  std::vector<std::string>{"4006381333931"}) << moduleSize;
+		EXPECT_EQ(read(OneD::Code128Writer().setMargin(0).encode(L"large", 1, 1), moduleSize),
+				  std::vector<std::string>{"large"}) << moduleSize;
+		EXPECT_EQ(read(OneD::ITFWriter().setMargin(0).encode(L"12345678", 1, 1), moduleSize),
+				  std::vector<std::string>{"12345678"}) << moduleSize;
+	}
+}
+
+TEST(ReadBarcodeTest, ParallelRowBands)
+{
+	// tall linear symbols that span several row bands and short ones close to the band boundaries
+	Canvas canvas(800, 1600);
+	canvas.draw(OneD::Code128Writer().setMargin(0).encode(L"tall", 300, 900), 50, 100);
+	canvas.draw(OneD::Code39Writer().setMargin(0).encode(L"SHORT", 300, 30), 450, 395);
+	canvas.draw(OneD::EAN13Writer().setMargin(0).encode(L"4006381333931", 250, 200), 450, 790);
+	canvas.draw(OneD::Code128Writer().setMargin(0).encode(L"bottom", 400, 60), 200, 1450);
+
+	const auto opts = ReaderOptions().formats(BarcodeFormat::AllLinear).maxThreads(1);
+	auto serial = ReadBarcodes(canvas.view(), opts);
+	ASSERT_EQ(Size(serial), 4);
+
+	// same symbols in the same order with the same line counts
+	for (int threads : {2, 4}) {
+		auto parallel = ReadBarcodes(canvas.view(), ReaderOptions(opts).maxThreads(threads));
+		ASSERT_EQ(Texts(parallel), Texts(serial));
+		for (int i = 0; i < Size(serial); ++i) {
+			EXPECT_EQ(parallel[i].position(), serial[i].position());
+			EXPECT_EQ(parallel[i].lineCount(), serial[i].lineCount());
+		}
+	}
+
+	// with a maxSymbols limit the result is the one of the serial scan
+	for (int maxSymbols : {1, 2, 3}) {
+		auto opts2 = ReaderOptions(opts).maxNumberOfSymbols(maxSymbols);
+		auto expected = Texts(ReadBarcodes(canvas.view(), opts2));
+		EXPECT_EQ(Size(expected), maxSymbols);
+		for (int threads : {2, 4})
+			EXPECT_EQ(Texts(ReadBarcodes(canvas.view(), ReaderOptions(opts2).maxThreads(threads))), expected);
+	}
+}
+
+TEST(ReadBarcodeTest, ParallelRowBandsOrder)
+{
+	// two symbols, the serial middle-out scan sees the one in the middle first
+	Canvas canvas(600, 1000);
+	canvas.draw(OneD::Code128Writer().setMargin(0).encode(L"top", 300, 150), 100, 20);
+	canvas.draw(OneD::Code128Writer().setMargin(0).encode(L"middle", 300, 100), 100, 450);
+
+	const auto opts = ReaderOptions().formats(BarcodeFormat::Code128).maxThreads(1);
+	auto serial = ReadBarcodes(canvas.view(), opts);
+	ASSERT_EQ(Size(serial), 2);
+	EXPECT_EQ(Texts(ReadBarcodes(canvas.view(), ReaderOptions(opts).maxNumberOfSymbols(1))), std::vector<std::string>{"middle"});
+
+	for (int threads : {2, 4}) {
+		auto parallel = ReaderOptions(opts).maxThreads(threads);
+		EXPECT_EQ(Texts(ReadBarcodes(canvas.view(), parallel)), Texts(serial));
+		EXPECT_EQ(Texts(ReadBarcodes(canvas.view(), parallel.maxNumberOfSymbols(1))), std::vector<std::string>{"middle"});
+	}
+}
+
+TEST(ReadBarcodeTest, AccumulateStackedRows)
+{
+	// a DataBar Expanded Stacked symbol with one pair per row, scaled to 3 pixels per module and 12 per row
+	const std::vector<std::vector<int>> rows = {
+		{1, 4, 1, 1, 2, 5, 1, 2, 1, 1, 8, 4, 1, 1, 1, 2, 1, 4, 3, 1, 2, 3, 1},
+		{1, 1, 3, 3, 2, 1, 2, 3, 1, 2, 1, 1, 4, 6, 3, 3, 1, 4, 1, 1, 5, 1, 1},
+		{1, 2, 1, 1, 1, 4, 5, 1, 2, 3, 6, 4, 1, 1, 1},
+	};
+	Canvas canvas(220, 76);
+	for (int r = 0; r < Size(rows); ++r) {
+		int x = 20;
+		for (int i = 0; i < Size(rows[r]); x += 3 * rows[r][i++])
+			for (int y = 20 + 12 * r; i % 2 == 0 && y < 32 + 12 * r; ++y)
+				std::fill_n(canvas.buf.begin() + y * canvas.width + x, 3 * rows[r][i], 0);
+	}
+
+	const auto opts = ReaderOptions().formats(BarcodeFormat::DataBarExpStk);
+	const auto expected = std::vector<std::string>{"(01)12345678901231"};
+	EXPECT_EQ(Texts(ReadBarcodes(canvas.view(), opts)), expected);
+	EXPECT_EQ(Texts(ReadBarcodes(canvas.view(), ReaderOptions(opts).accumulateStackedRows(true))), expected);
+
+	// the first two rows are in the top tile, the last one in the bottom tile
+	auto top = canvas.view().cropped(0, 0, canvas.width, 44);
+	auto bottom = canvas.view().cropped(0, 44, canvas.width, canvas.height - 44);
+	for (bool accumulate : {false, true}) {
+		ReaderContext context(ReaderOptions(opts).accumulateStackedRows(accumulate));
+		EXPECT_TRUE(context.read(top).empty());
+		EXPECT_EQ(Texts(context.read(bottom)), accumulate ? expected : std::vector<std::string>{});
+	}
+
+	// the rows are dropped after 8 frames without new ones, no matter how many scans the frames in between take
+	for (int width : {220, 1600}) {
+		Canvas empty(width, width / 2);
+		for (int gap : {7, 8}) {
+			ReaderContext context(ReaderOptions(opts).accumulateStackedRows(true));
+			context.read(top);
+			for (int i = 0; i < gap; ++i)
+				context.read(empty.view());
+			EXPECT_EQ(Texts(context.read(bottom)), gap < 8 ? expected : std::vector<std::string>{}) << width << " " << gap;
+		}
+	}
+}
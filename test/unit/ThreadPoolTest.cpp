@@ -0,0 +1,82 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "BitMatrix.h"
+#include "GlobalHistogramBinarizer.h"
+#include "HybridBinarizer.h"
+#include "ParallelFor.h"
+#include "PseudoRandom.h"
+#include "ThreadPool.h"
+#include "ThresholdBinarizer.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace ZXing;
+
+TEST(ThreadPoolTest, ParallelFor)
+{
+	ThreadPool pool(2);
+	EXPECT_EQ(pool.concurrency(), 2);
+
+	for (int maxThreads : {0, 1, 3, 8}) {
+		std::vector<std::atomic<int>> counts(100);
+		ParallelFor(&pool, maxThreads, Size(counts), [&](int i) { ++counts[i]; });
+		for (auto& c : counts)
+			EXPECT_EQ(c, 1);
+	}
+}
+
+TEST(ThreadPoolTest, NestedParallelFor)
+{
+	// all pool threads are busy with the outer loop, the inner loops must still complete
+	ThreadPool pool(2);
+	std::atomic<int> sum = 0;
+	ParallelFor(&pool, 0, 8, [&](int) { ParallelFor(&pool, 0, 8, [&](int j) { sum += j; }); });
+	EXPECT_EQ(sum, 8 * 28);
+}
+
+TEST(ThreadPoolTest, Exception)
+{
+	ThreadPool pool(2);
+	std::atomic<int> calls = 0;
+	EXPECT_THROW(ParallelFor(&pool, 3, 10,
+							 [&](int i) {
+								 ++calls;
+								 if (i == 5)
+									 throw std::runtime_error("test");
+							 }),
+				 std::runtime_error);
+	EXPECT_EQ(calls, 10);
+}
+
+TEST(ThreadPoolTest, BandedBinarization)
+{
+	// large enough for several bands, with a height that is not a multiple of the block size
+	const int w = 1000, h = 1203;
+	PseudoRandom rand(42);
+	std::vector<uint8_t> img(w * h);
+	for (int y = 0; y < h; ++y)
+		for (int x = 0; x < w; ++x)
+			img[y * w + x] = static_cast<uint8_t>(((x / 16 + y / 16) % 2 ? 60 : 180) + rand.next(0, 40));
+	ImageView iv(img.data(), w, h, ImageFormat::Lum);
+
+	ThreadPool pool(3);
+
+	auto check = [&](auto serial, auto banded) {
+		banded.setConcurrency(&pool, 4);
+		auto expected = serial.getBitMatrix();
+		auto actual = banded.getBitMatrix();
+		ASSERT_TRUE(expected && actual);
+		EXPECT_EQ(*expected, *actual);
+	};
+
+	check(HybridBinarizer(iv), HybridBinarizer(iv));
+	check(GlobalHistogramBinarizer(iv), GlobalHistogramBinarizer(iv));
+	check(ThresholdBinarizer(iv, 127), ThresholdBinarizer(iv, 127));
+}
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "oned/ODCode128Reader.h"
+#include "oned/ODCode128Patterns.h"
 
 #include "ReaderOptions.h"
 #include "Barcode.h"
@@ -135,3 +136,22 @@ TEST(ODCode128ReaderTest, ISO8859_1)
 		EXPECT_EQ(result.text(), "a\u00E9\u00A0");
 	}
 }
+
+TEST(ODCode128ReaderTest, E2EIndex)
+{
+	using namespace Code128;
+
+	EXPECT_EQ(std::ranges::count_if(E2E_INDEX, [](int i) { return i != -1; }), Size(CODE_PATTERNS));
+
+	for (int i = 0; i < Size(CODE_PATTERNS); ++i) {
+		// 3 pixels per module with one element off by one pixel
+		PatternRow row = {0}; // the quiet zone in front
+		for (auto v : CODE_PATTERNS[i])
+			row.push_back(3 * v);
+		row[1 + i % CHAR_LEN] += i % 2 ? 1 : -1;
+		EXPECT_EQ((LookupE2EPattern<CHAR_LEN, CHAR_MODS>(PatternView(row), E2E_INDEX)), i);
+	}
+
+	PatternRow wide = {0, 1, 1, 1, 1, 1, 20};
+	EXPECT_EQ((LookupE2EPattern<CHAR_LEN, CHAR_MODS>(PatternView(wide), E2E_INDEX)), -1);
+}
@@ -5,6 +5,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "oned/ODCode93Reader.h"
+#include "oned/ODCode93Patterns.h"
 #include "BitArray.h"
 #include "BitArrayUtility.h"
 #include "ReaderOptions.h"
@@ -35,3 +36,18 @@ TEST(ODCode93ReaderTest, Decode)
 		"10110101000101011110100000");
 	EXPECT_EQ(expected, decoded);
 }
+
+TEST(ODCode93ReaderTest, E2EIndex)
+{
+	using namespace Code93;
+
+	EXPECT_EQ(std::ranges::count_if(E2E_INDEX, [](int i) { return i != -1; }), Size(CODE_PATTERNS));
+
+	for (int i = 0; i < Size(CODE_PATTERNS); ++i) {
+		PatternRow row = {0}; // the quiet zone in front
+		for (auto v : CODE_PATTERNS[i])
+			row.push_back(4 * v);
+		row[1 + i % CHAR_LEN] += i % 2 ? 1 : -1;
+		EXPECT_EQ((LookupE2EPattern<CHAR_LEN, CHAR_MODS>(PatternView(row), E2E_INDEX)), i);
+	}
+}
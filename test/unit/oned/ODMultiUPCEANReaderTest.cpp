@@ -0,0 +1,71 @@
+/*
+* Copyright 2026 Axel Waggershauser
+*/
+// SPDX-License-Identifier: Apache-2.0
+
+#include "oned/ODMultiUPCEANReader.h"
+
+#include "BitMatrix.h"
+#include "ReaderOptions.h"
+#include "oned/ODEAN13Writer.h"
+#include "oned/ODEAN8Writer.h"
+#include "oned/ODUPCAWriter.h"
+#include "oned/ODUPCEWriter.h"
+
+#include "gtest/gtest.h"
+
+using namespace ZXing;
+using namespace ZXing::OneD;
+
+static PatternRow ToPatternRow(const BitMatrix& matrix)
+{
+	PatternRow row;
+	GetPatternRow(matrix.row(0), row);
+	return row;
+}
+
+static Barcode Decode(const PatternRow& row, const ReaderOptions& opts)
+{
+	MultiUPCEANReader reader(opts);
+	PatternView next(row);
+	std::unique_ptr<RowReader::DecodingState> state;
+	return reader.decodePattern(0, next, state);
+}
+
+TEST(ODMultiUPCEANReaderTest, Formats)
+{
+	// all formats share the decoding of the left hand digits
+	const auto opts = ReaderOptions().formats(BarcodeFormat::EANUPC);
+
+	auto res = Decode(ToPatternRow(EAN13Writer().setMargin(10).encode(L"4006381333931", 200, 1)), opts);
+	EXPECT_EQ(res.format(), BarcodeFormat::EAN13);
+	EXPECT_EQ(res.text(), "4006381333931");
+
+	res = Decode(ToPatternRow(EAN8Writer().setMargin(10).encode(L"96385074", 150, 1)), opts);
+	EXPECT_EQ(res.format(), BarcodeFormat::EAN8);
+	EXPECT_EQ(res.text(), "96385074");
+
+	res = Decode(ToPatternRow(UPCEWriter().setMargin(10).encode(L"01234565", 150, 1)), opts);
+	EXPECT_EQ(res.format(), BarcodeFormat::UPCE);
+	EXPECT_EQ(res.text(), "0012345000065"); // converted to EAN-13, see ISO/IEC 15420:2009
+
+	res = Decode(ToPatternRow(UPCAWriter().setMargin(10).encode(L"036000291452", 200, 1)),
+				 ReaderOptions().formats(BarcodeFormat::UPCA));
+	EXPECT_EQ(res.format(), BarcodeFormat::UPCA);
+	EXPECT_EQ(res.text(), "0036000291452");
+}
+
+TEST(ODMultiUPCEANReaderTest, ChecksumError)
+{
+	auto row = ToPatternRow(EAN13Writer().setMargin(10).encode(L"4006381333931", 95, 1));
+	ASSERT_EQ(Size(row), 1 + 59 + 1);
+	// replace the check digit with the digit in front of it: 4006381333933
+	std::copy_n(row.begin() + 1 + 3 + 24 + 5 + 4 * 4, 4, row.begin() + 1 + 3 + 24 + 5 + 5 * 4);
+
+	const auto opts = ReaderOptions().formats(BarcodeFormat::EAN13);
+	EXPECT_FALSE(Decode(row, opts).isValid());
+
+	auto res = Decode(row, ReaderOptions(opts).returnErrors(true));
+	EXPECT_EQ(res.error().type(), Error::Type::Checksum);
+	EXPECT_EQ(res.text(), "4006381333933");
+}
@@ -8,6 +8,7 @@
 
 #include "BitMatrix.h"
 #include "BitMatrixIO.h"
+#include "qrcode/QRDataMask.h"
 
 #include "gtest/gtest.h"
 
@@ -207,3 +208,37 @@ TEST(QRVersionTest, RMQRFunctionPattern)
 		EXPECT_EQ(expected, functionPattern);
 	}
 }
+
+TEST(QRVersionTest, CachedLayout)
+{
+	auto checkLayout = [](const Version* version) {
+		ASSERT_NE(version, nullptr);
+		EXPECT_EQ(&version->dataModules(), &version->dataModules());
+
+		for (auto [x, y, masks] : version->dataModules())
+			for (int i = 0; i < 8; ++i)
+				EXPECT_EQ(bool((masks >> i) & 1), GetDataMaskBit(i, x, y));
+
+		if (version->isModel1()) // Model 1 places its codewords in blocks that do not simply fill the gaps
+			return;
+
+		// every module is either part of the function pattern or exactly one data module
+		BitMatrix covered = version->buildFunctionPattern();
+		for (auto [x, y, masks] : version->dataModules()) {
+			EXPECT_FALSE(covered.get(x, y)) << version->versionNumber() << " (" << int(x) << ',' << int(y) << ')';
+			covered.set(x, y);
+		}
+		for (int y = 0; y < covered.height(); ++y)
+			for (int x = 0; x < covered.width(); ++x)
+				EXPECT_TRUE(covered.get(x, y));
+	};
+
+	for (int i = 1; i <= 40; i++)
+		checkLayout(Version::Model2(i));
+	for (int i = 1; i <= 14; i++)
+		checkLayout(Version::Model1(i));
+	for (int i = 1; i <= 4; i++)
+		checkLayout(Version::Micro(i));
+	for (int i = 1; i <= 32; i++)
+		checkLayout(Version::rMQR(i));
+}